@@ -5,6 +5,8 @@
 #include <vector>
 #include <string>
 #include <map>
+#include <unordered_map>
+#include <unordered_set>
 #include <algorithm>
 #include <fstream>
 #include <iomanip>
@@ -12,6 +14,33 @@
 #include <sstream>
 #include <limits>
 #include <memory>
+#include <cmath>
+#include <atomic>
+#include <cctype>
+#include <memory_resource>
+#include <cstdint>
+#include <cstdio>
+#include <chrono>
+#include <thread>
+#include <mutex>
+#include <shared_mutex>
+#include <functional>
+#include <filesystem>
+#include <optional>
+
+#ifdef _WIN32
+#define NOMINMAX
+#define WIN32_LEAN_AND_MEAN
+#include <windows.h>
+#include <psapi.h>
+#pragma comment(lib, "psapi.lib")
+#else
+#include <sys/resource.h>
+#endif
+
+#ifdef _MSC_VER
+#include <intrin.h>
+#endif
 
 #include "File_Z.h"
 
@@ -25,28 +54,205 @@ class Table;
 class MenuItem;
 
 // Utility functions
-std::string getCurrentDateTime() {
-    time_t now = time(0);
+
+// Thread-safe localtime; terminal sessions format times concurrently
+struct tm toLocalTime(time_t when) {
+    struct tm tstruct;
+#ifdef _WIN32
+    localtime_s(&tstruct, &when);
+#else
+    localtime_r(&when, &tstruct);
+#endif
+    return tstruct;
+}
+
+std::string formatDateTime(time_t when) {
     struct tm tstruct;
     char buf[80];
-    tstruct = *localtime(&now);
+    tstruct = toLocalTime(when);
     strftime(buf, sizeof(buf), "%Y-%m-%d %X", &tstruct);
     return std::string(buf);
 }
 
+std::string getCurrentDateTime() {
+    return formatDateTime(time(0));
+}
+
+// Parse "YYYY-MM-DD HH:MM[:SS]" as local time; returns -1 if it doesn't parse
+time_t parseDateTime(const std::string& text) {
+    struct tm tstruct = {};
+    int seconds = 0;
+    int fields = std::sscanf(text.c_str(), "%d-%d-%d %d:%d:%d", &tstruct.tm_year, &tstruct.tm_mon, &tstruct.tm_mday,
+        &tstruct.tm_hour, &tstruct.tm_min, &seconds);
+    if (fields < 5) {
+        return static_cast<time_t>(-1);
+    }
+    tstruct.tm_year -= 1900;
+    tstruct.tm_mon -= 1;
+    tstruct.tm_sec = seconds;
+    tstruct.tm_isdst = -1;
+    return mktime(&tstruct);
+}
+
+// Local midnight at the start of the day containing 'when', shifted by dayOffset days
+time_t startOfDay(time_t when, int dayOffset = 0) {
+    struct tm tstruct = toLocalTime(when);
+    tstruct.tm_hour = 0;
+    tstruct.tm_min = 0;
+    tstruct.tm_sec = 0;
+    tstruct.tm_mday += dayOffset;
+    tstruct.tm_isdst = -1;
+    return mktime(&tstruct);
+}
+
+// Today's date as YYYY-MM-DD, matching the first 10 characters of getCurrentDateTime()
+std::string getCurrentDate() {
+    return getCurrentDateTime().substr(0, 10);
+}
+
+// 64-bit identifier used internally for orders and reservations. The top bits
+// name the terminal that issued the id and the rest is that terminal's own
+// sequence, so several terminals can hand out ids without talking to each other.
+// The letter prefix only exists in the text form: "O12" for terminal 0,
+// "O3-12" for sequence 12 issued by terminal 3.
+template<char Prefix>
+class TypedId {
+private:
+    unsigned long long value;
+
+public:
+    static const int TERMINAL_BITS = 16;
+    static const int SEQUENCE_BITS = 64 - TERMINAL_BITS;
+    static const unsigned long long SEQUENCE_MASK = (1ULL << SEQUENCE_BITS) - 1;
+    static const unsigned MAX_TERMINAL = (1U << TERMINAL_BITS) - 1;
+
+    TypedId() : value(0) {}
+    explicit TypedId(unsigned long long rawValue) : value(rawValue) {}
+
+    static TypedId make(unsigned terminal, unsigned long long sequence) {
+        return TypedId((static_cast<unsigned long long>(terminal) << SEQUENCE_BITS) | (sequence & SEQUENCE_MASK));
+    }
+
+    unsigned long long getValue() const { return value; }
+    unsigned getTerminal() const { return static_cast<unsigned>(value >> SEQUENCE_BITS); }
+    unsigned long long getSequence() const { return value & SEQUENCE_MASK; }
+    bool isValid() const { return getSequence() != 0; } // Sequence 0 is never issued
+
+    std::string toString() const {
+        if (getTerminal() == 0) {
+            return std::string(1, Prefix) + std::to_string(getSequence());
+        }
+        return std::string(1, Prefix) + std::to_string(getTerminal()) + "-" + std::to_string(getSequence());
+    }
+
+    // Same text as toString, written into buffer without allocating; returns its length
+    int formatTo(char* buffer, size_t size) const {
+        if (getTerminal() == 0) {
+            return std::snprintf(buffer, size, "%c%llu", Prefix, getSequence());
+        }
+        return std::snprintf(buffer, size, "%c%u-%llu", Prefix, getTerminal(), getSequence());
+    }
+
+    // Accepts "O12", "O3-12" or a bare "12"; returns an invalid id on bad input
+    static TypedId parse(const std::string& text) {
+        size_t pos = 0;
+        if (pos < text.size() && std::toupper(static_cast<unsigned char>(text[pos])) == Prefix) {
+            pos++;
+        }
+
+        unsigned long long first = 0, second = 0;
+        bool haveTerminal = false;
+        size_t digits = 0;
+        for (; pos < text.size(); pos++) {
+            char c = text[pos];
+            if (c == '-' && !haveTerminal && digits > 0) {
+                haveTerminal = true;
+                digits = 0;
+                continue;
+            }
+            if (!std::isdigit(static_cast<unsigned char>(c)) || digits >= 15) {
+                return TypedId();
+            }
+            unsigned long long& target = haveTerminal ? second : first;
+            target = target * 10 + static_cast<unsigned long long>(c - '0');
+            digits++;
+        }
+        if (digits == 0) {
+            return TypedId();
+        }
+        if (!haveTerminal) {
+            return make(0, first);
+        }
+        if (first > MAX_TERMINAL) {
+            return TypedId();
+        }
+        return make(static_cast<unsigned>(first), second);
+    }
+
+    bool operator==(const TypedId& other) const { return value == other.value; }
+    bool operator!=(const TypedId& other) const { return value != other.value; }
+    bool operator<(const TypedId& other) const { return value < other.value; }
+    bool operator>(const TypedId& other) const { return value > other.value; }
+};
+
+template<char Prefix>
+std::ostream& operator<<(std::ostream& out, const TypedId<Prefix>& id) {
+    return out << id.toString();
+}
+
+namespace std {
+    template<char Prefix>
+    struct hash<TypedId<Prefix>> {
+        size_t operator()(const TypedId<Prefix>& id) const {
+            return std::hash<unsigned long long>()(id.getValue());
+        }
+    };
+}
+
+typedef TypedId<'O'> OrderId;
+typedef TypedId<'R'> ReservationId;
+
+// Hands out ids for one terminal
+template<typename IdType>
+class IdGenerator {
+private:
+    unsigned terminal;
+    std::atomic<unsigned long long> nextSequence;
+
+public:
+    explicit IdGenerator(unsigned terminal = 0) : terminal(terminal), nextSequence(1) {}
+
+    IdType next() {
+        return IdType::make(terminal, nextSequence.fetch_add(1));
+    }
+
+    // Make sure ids issued before a restart are never handed out again
+    void skipPast(unsigned long long usedSequence) {
+        unsigned long long current = nextSequence.load();
+        while (current <= usedSequence && !nextSequence.compare_exchange_weak(current, usedSequence + 1)) {
+        }
+    }
+
+    unsigned getTerminal() const { return terminal; }
+};
+
 // class for additems to live moitor 
 //rik
 
 class KitchenOrder : public TwoCli::stbase {
 public:
-    int id;
+    OrderId id;
     int tableNumber;
     std::string status;
     std::string itemList;
 
     // Required by stbase
     std::string toString() const override {
-        return std::to_string(id) + "|" + std::to_string(tableNumber) + "|" + status + "|" + itemList;
+        return id.toString() + "|" + std::to_string(tableNumber) + "|" + status + "|" + itemList;
+    }
+
+    bool operator==(const KitchenOrder& other) const {
+        return id == other.id && tableNumber == other.tableNumber && status == other.status && itemList == other.itemList;
     }
 
     // Required by FileManager
@@ -56,7 +262,10 @@ public:
         std::string part;
 
         getline(ss, part, '|');
-        order.id = std::stoi(part);
+        order.id = OrderId::parse(part);
+        if (!order.id.isValid()) {
+            throw std::invalid_argument("bad order id");
+        }
 
         getline(ss, part, '|');
         order.tableNumber = std::stoi(part);
@@ -109,7 +318,10 @@ public:
         std::cout << "3. View Reservations\n";
         std::cout << "4. Add Reservation\n";
         std::cout << "5. Cancel Reservation\n";
-        std::cout << "6. Return to Main Menu\n";
+        std::cout << "6. Find Reservation\n";
+        std::cout << "7. Add to Waitlist\n";
+        std::cout << "8. Seat Waitlist\n";
+        std::cout << "9. Return to Main Menu\n";
     }
 };
 
@@ -152,7 +364,9 @@ public:
         std::cout << "1. View Pending Orders\n";
         std::cout << "2. Update Order Status\n";
         std::cout << "3. Live Order Monitor\n";  // New option
-        std::cout << "4. Return to Main Menu\n";
+        std::cout << "4. View Station Queues\n";
+        std::cout << "5. Complete Station Ticket\n";
+        std::cout << "6. Return to Main Menu\n";
     }
 
 
@@ -173,7 +387,9 @@ public:
         std::cout << "3. Manage Menu Items\n";
         std::cout << "4. Generate Reports\n";
         std::cout << "5. Manage Staff\n";
-        std::cout << "6. Return to Main Menu\n";
+        std::cout << "6. End Shift\n";
+        std::cout << "7. Live Dashboard\n";
+        std::cout << "8. Return to Main Menu\n";
     }
 };
 
@@ -326,26 +542,298 @@ public:
     }
 };
 
+// Money is kept in whole cents so running totals can be adjusted without drift
+inline long long toCents(double amount) {
+    return std::llround(amount * 100.0);
+}
+
+// Escape the separator characters used by the archive line format
+std::string escapeField(const std::string& text) {
+    std::string out;
+    out.reserve(text.size());
+    for (char c : text) {
+        switch (c) {
+        case '\\': out += "\\\\"; break;
+        case '|': out += "\\p"; break;
+        case ';': out += "\\s"; break;
+        case ',': out += "\\c"; break;
+        case '\n': out += "\\n"; break;
+        default: out += c;
+        }
+    }
+    return out;
+}
+
+std::string unescapeField(const std::string& text) {
+    std::string out;
+    out.reserve(text.size());
+    for (size_t i = 0; i < text.size(); ++i) {
+        if (text[i] != '\\' || i + 1 == text.size()) {
+            out += text[i];
+            continue;
+        }
+        switch (text[++i]) {
+        case 'p': out += '|'; break;
+        case 's': out += ';'; break;
+        case 'c': out += ','; break;
+        case 'n': out += '\n'; break;
+        default: out += text[i];
+        }
+    }
+    return out;
+}
+
+// Quote a string for a JSON line
+std::string jsonQuote(const std::string& text) {
+    std::string out = "\"";
+    for (char c : text) {
+        switch (c) {
+        case '"': out += "\\\""; break;
+        case '\\': out += "\\\\"; break;
+        case '\n': out += "\\n"; break;
+        case '\r': out += "\\r"; break;
+        case '\t': out += "\\t"; break;
+        default:
+            if (static_cast<unsigned char>(c) < 0x20) {
+                char escaped[8];
+                std::snprintf(escaped, sizeof(escaped), "\\u%04x", static_cast<unsigned>(static_cast<unsigned char>(c)));
+                out += escaped;
+            }
+            else {
+                out += c;
+            }
+        }
+    }
+    return out + "\"";
+}
+
+// Value of "key" in a flat JSON line, unquoted; empty if absent
+std::string jsonField(const std::string& line, const std::string& key) {
+    std::string marker = "\"" + key + "\":";
+    size_t at = line.find(marker);
+    if (at == std::string::npos) {
+        return "";
+    }
+    at += marker.size();
+    std::string value;
+    if (at < line.size() && line[at] == '"') {
+        for (size_t i = at + 1; i < line.size() && line[i] != '"'; ++i) {
+            if (line[i] == '\\' && i + 1 < line.size()) {
+                char next = line[++i];
+                value += next == 'n' ? '\n' : next == 't' ? '\t' : next == 'r' ? '\r' : next;
+            }
+            else {
+                value += line[i];
+            }
+        }
+        return value;
+    }
+    size_t end = line.find_first_of(",}", at);
+    return line.substr(at, end == std::string::npos ? std::string::npos : end - at);
+}
+
+// Split on a separator, leaving escaped separators alone
+std::vector<std::string> splitFields(const std::string& text, char separator) {
+    std::vector<std::string> fields;
+    std::string current;
+    for (size_t i = 0; i < text.size(); ++i) {
+        if (text[i] == '\\' && i + 1 < text.size()) {
+            current += text[i];
+            current += text[++i];
+        }
+        else if (text[i] == separator) {
+            fields.push_back(current);
+            current.clear();
+        }
+        else {
+            current += text[i];
+        }
+    }
+    fields.push_back(current);
+    return fields;
+}
+
+// Peak resident set size of this process in KB
+long long getPeakRssKb() {
+#ifdef _WIN32
+    PROCESS_MEMORY_COUNTERS counters;
+    if (GetProcessMemoryInfo(GetCurrentProcess(), &counters, sizeof(counters))) {
+        return static_cast<long long>(counters.PeakWorkingSetSize / 1024);
+    }
+    return 0;
+#else
+    struct rusage usage;
+    getrusage(RUSAGE_SELF, &usage);
+    return usage.ru_maxrss; // Already in KB on Linux
+#endif
+}
+
+// memory_resource wrapper that counts what passes through it to the upstream
+class CountingResource : public std::pmr::memory_resource {
+private:
+    std::pmr::memory_resource* upstream;
+    size_t allocations;
+    size_t bytesAllocated;
+    size_t bytesInUse;
+    size_t peakBytesInUse;
+
+protected:
+    void* do_allocate(size_t bytes, size_t alignment) override {
+        void* block = upstream->allocate(bytes, alignment);
+        allocations++;
+        bytesAllocated += bytes;
+        bytesInUse += bytes;
+        peakBytesInUse = std::max(peakBytesInUse, bytesInUse);
+        return block;
+    }
+
+    void do_deallocate(void* block, size_t bytes, size_t alignment) override {
+        upstream->deallocate(block, bytes, alignment);
+        bytesInUse -= bytes;
+    }
+
+    bool do_is_equal(const std::pmr::memory_resource& other) const noexcept override {
+        return this == &other;
+    }
+
+public:
+    explicit CountingResource(std::pmr::memory_resource* upstream = std::pmr::new_delete_resource())
+        : upstream(upstream), allocations(0), bytesAllocated(0), bytesInUse(0), peakBytesInUse(0) {
+    }
+
+    size_t getAllocations() const { return allocations; }
+    size_t getBytesAllocated() const { return bytesAllocated; }
+    size_t getBytesInUse() const { return bytesInUse; }
+    size_t getPeakBytesInUse() const { return peakBytesInUse; }
+};
+
+// Serialises access to a resource that isn't thread-safe itself
+class LockedResource : public std::pmr::memory_resource {
+private:
+    std::pmr::memory_resource* upstream;
+    std::mutex resourceMutex;
+
+protected:
+    void* do_allocate(size_t bytes, size_t alignment) override {
+        std::lock_guard<std::mutex> lock(resourceMutex);
+        return upstream->allocate(bytes, alignment);
+    }
+
+    void do_deallocate(void* p, size_t bytes, size_t alignment) override {
+        std::lock_guard<std::mutex> lock(resourceMutex);
+        upstream->deallocate(p, bytes, alignment);
+    }
+
+    bool do_is_equal(const std::pmr::memory_resource& other) const noexcept override {
+        return this == &other;
+    }
+
+public:
+    explicit LockedResource(std::pmr::memory_resource* upstream) : upstream(upstream) {}
+};
+
+// Arena for the order data of one service shift. When enabled, item lists and
+// strings of orders taken during the shift are carved out of large blocks and
+// handed back all at once by release() at end of day; individual frees are
+// no-ops. When disabled, orders use the normal heap as before.
+class ShiftArena {
+private:
+    CountingResource blocks; // Counts the blocks the arena takes from the heap
+    std::pmr::monotonic_buffer_resource arena;
+    LockedResource sharedArena; // What orders allocate from, so several terminals can share the arena
+    bool enabled;
+
+public:
+    explicit ShiftArena(bool enabled, size_t initialBlockSize = 64 * 1024)
+        : arena(initialBlockSize, &blocks), sharedArena(&arena), enabled(enabled) {
+    }
+
+    std::pmr::memory_resource* resource() {
+        return enabled ? static_cast<std::pmr::memory_resource*>(&sharedArena) : std::pmr::get_default_resource();
+    }
+
+    // Only safe once no order allocated from the arena is still alive
+    void release() {
+        arena.release();
+    }
+
+    bool isEnabled() const { return enabled; }
+    size_t getBlockCount() const { return blocks.getAllocations(); }
+    size_t getBytesReserved() const { return blocks.getBytesInUse(); }
+};
+
 // Class for order items
+// Each line keeps its own copy of the menu item's id, name and price so an order
+// still reads correctly after the menu changes or once it has been archived.
+// Allocator-aware so that an Order's item list can place the strings in the
+// same memory resource (e.g. the shift arena) as the list itself.
 class OrderItem {
 private:
-    MenuItem* menuItem;
+    std::pmr::string itemId;
+    std::pmr::string itemName;
     int quantity;
-    std::string specialInstructions;
+    std::pmr::string specialInstructions;
+    double unitPrice; // Price snapshot taken when the item was ordered
 
 public:
-    OrderItem(MenuItem* menuItem, int quantity, const std::string& specialInstructions = "")
-        : menuItem(menuItem), quantity(quantity), specialInstructions(specialInstructions) {
+    typedef std::pmr::polymorphic_allocator<char> allocator_type;
+
+    OrderItem(const MenuItem* menuItem, int quantity, const std::string& specialInstructions = "",
+        const allocator_type& alloc = {})
+        : itemId(menuItem->getId(), alloc), itemName(menuItem->getName(), alloc), quantity(quantity),
+        specialInstructions(specialInstructions, alloc), unitPrice(menuItem->getPrice()) {
+    }
+
+    // Used when restoring an archived order
+    OrderItem(const std::string& itemId, const std::string& itemName, double unitPrice,
+        int quantity, const std::string& specialInstructions, const allocator_type& alloc = {})
+        : itemId(itemId, alloc), itemName(itemName, alloc), quantity(quantity),
+        specialInstructions(specialInstructions, alloc), unitPrice(unitPrice) {
+    }
+
+    OrderItem(const OrderItem& other, const allocator_type& alloc)
+        : itemId(other.itemId, alloc), itemName(other.itemName, alloc), quantity(other.quantity),
+        specialInstructions(other.specialInstructions, alloc), unitPrice(other.unitPrice) {
+    }
+
+    OrderItem(OrderItem&& other, const allocator_type& alloc)
+        : itemId(std::move(other.itemId), alloc), itemName(std::move(other.itemName), alloc), quantity(other.quantity),
+        specialInstructions(std::move(other.specialInstructions), alloc), unitPrice(other.unitPrice) {
     }
 
-    double getSubtotal() const { return menuItem->getPrice() * quantity; }
-    MenuItem* getMenuItem() const { return menuItem; }
+    OrderItem(const OrderItem&) = default;
+    OrderItem(OrderItem&&) = default;
+    OrderItem& operator=(const OrderItem&) = default;
+    OrderItem& operator=(OrderItem&&) = default;
+
+    double getSubtotal() const { return unitPrice * quantity; }
+    long long getSubtotalCents() const { return toCents(unitPrice) * quantity; }
+    std::string getItemId() const { return std::string(itemId); }
+    std::string getItemName() const { return std::string(itemName); }
     int getQuantity() const { return quantity; }
-    std::string getSpecialInstructions() const { return specialInstructions; }
+    double getUnitPrice() const { return unitPrice; }
+    std::string getSpecialInstructions() const { return std::string(specialInstructions); }
+
+    void setQuantity(int newQuantity) { quantity = newQuantity; }
+    void setUnitPrice(double newPrice) { unitPrice = newPrice; }
+
+    std::string toString() const {
+        return escapeField(getItemId()) + "," + escapeField(getItemName()) + "," + std::to_string(toCents(unitPrice)) + ","
+            + std::to_string(quantity) + "," + escapeField(getSpecialInstructions());
+    }
+
+    static OrderItem fromString(const std::string& text) {
+        std::vector<std::string> fields = splitFields(text, ',');
+        if (fields.size() != 5) {
+            throw std::invalid_argument("bad order item");
+        }
+        return OrderItem(unescapeField(fields[0]), unescapeField(fields[1]), std::stoll(fields[2]) / 100.0,
+            std::stoi(fields[3]), unescapeField(fields[4]));
+    }
 
     void display() const {
-        std::cout << std::left << std::setw(5) << menuItem->getId()
-            << std::setw(25) << menuItem->getName()
+        std::cout << std::left << std::setw(5) << itemId
+            << std::setw(25) << itemName
             << std::setw(10) << quantity
             << std::setw(30) << specialInstructions
             << "$" << std::fixed << std::setprecision(2) << getSubtotal() << std::endl;
@@ -368,45 +856,230 @@ std::string orderStatusToString(OrderStatus status) {
     }
 }
 
+const int ORDER_STATUS_COUNT = 6;
+
+// The order lifecycle. Any change not listed here is rejected.
+bool isAllowedTransition(OrderStatus from, OrderStatus to) {
+    static const bool allowed[ORDER_STATUS_COUNT][ORDER_STATUS_COUNT] = {
+        //            Pending InProgress Ready  Served Completed Cancelled
+        /* Pending    */ { false, true,  true,  false, false, true },
+        /* InProgress */ { false, false, true,  false, false, true },
+        /* Ready      */ { false, false, false, true,  true,  false },
+        /* Served     */ { false, false, false, false, true,  false },
+        /* Completed  */ { false, false, false, false, false, false },
+        /* Cancelled  */ { false, false, false, false, false, false },
+    };
+    return allowed[static_cast<int>(from)][static_cast<int>(to)];
+}
+
 // Class for orders
-class Order {
+class Order : public TwoCli::stbase {
 private:
-    std::string orderId;
-    std::vector<OrderItem> items;
-    OrderStatus status;
-    std::string timestamp;
+    OrderId orderId;
+    std::pmr::vector<OrderItem> items;
+    std::atomic<OrderStatus> status; // Atomic so it can be read without the repository lock
+    std::pmr::string timestamp;
+    time_t placedAt;
     int tableNumber;
-    std::string waiterId;
+    std::pmr::string waiterId;
+
+    // Running totals, kept in step with items by every mutator below
+    long long subtotalCents;
+    long long taxCents;
+
+    void refreshTax() {
+        taxCents = std::llround(subtotalCents * GST_RATE);
+    }
+
+    // Status changes go through OrderRepository so its indexes stay in step
+    friend class OrderRepository;
+
+    // Move to 'to' if that is allowed from the current status; 'from'
+    // receives the status that was replaced, or the one that blocked the
+    // change. Callers serialise changes to an order (RestaurantSystem holds
+    // the order's lock), so the check and the store cannot interleave.
+    bool transitionStatus(OrderStatus to, OrderStatus& from) {
+        from = status.load(std::memory_order_relaxed);
+        if (!isAllowedTransition(from, to)) {
+            return false;
+        }
+        status.store(to, std::memory_order_release);
+        return true;
+    }
 
 public:
-    Order(const std::string& orderId, int tableNumber, const std::string& waiterId)
-        : orderId(orderId), status(OrderStatus::Pending), tableNumber(tableNumber), waiterId(waiterId) {
-        timestamp = getCurrentDateTime();
+    static constexpr double GST_RATE = 0.15; // 15% GST
+
+    // Placeholder filled in by fromString
+    Order() : status(OrderStatus::Pending), placedAt(0), tableNumber(0), subtotalCents(0), taxCents(0) {}
+
+    // The atomic status rules out the defaulted copy and move operations
+    Order(const Order& other)
+        : TwoCli::stbase(other), orderId(other.orderId), items(other.items), status(other.getStatus()),
+        timestamp(other.timestamp), placedAt(other.placedAt), tableNumber(other.tableNumber),
+        waiterId(other.waiterId), subtotalCents(other.subtotalCents), taxCents(other.taxCents) {
+    }
+
+    Order(Order&& other) noexcept
+        : TwoCli::stbase(std::move(other)), orderId(other.orderId), items(std::move(other.items)), status(other.getStatus()),
+        timestamp(std::move(other.timestamp)), placedAt(other.placedAt), tableNumber(other.tableNumber),
+        waiterId(std::move(other.waiterId)), subtotalCents(other.subtotalCents), taxCents(other.taxCents) {
+    }
+
+    Order& operator=(const Order& other) {
+        if (this != &other) {
+            orderId = other.orderId;
+            items = other.items;
+            status.store(other.getStatus());
+            timestamp = other.timestamp;
+            placedAt = other.placedAt;
+            tableNumber = other.tableNumber;
+            waiterId = other.waiterId;
+            subtotalCents = other.subtotalCents;
+            taxCents = other.taxCents;
+        }
+        return *this;
+    }
+
+    Order& operator=(Order&& other) noexcept {
+        if (this != &other) {
+            orderId = other.orderId;
+            items = std::move(other.items);
+            status.store(other.getStatus());
+            timestamp = std::move(other.timestamp);
+            placedAt = other.placedAt;
+            tableNumber = other.tableNumber;
+            waiterId = std::move(other.waiterId);
+            subtotalCents = other.subtotalCents;
+            taxCents = other.taxCents;
+        }
+        return *this;
+    }
+
+    // Item list and strings are allocated from the given resource (the heap by default)
+    Order(OrderId orderId, int tableNumber, const std::string& waiterId,
+        std::pmr::memory_resource* resource = std::pmr::get_default_resource())
+        : orderId(orderId), items(resource), status(OrderStatus::Pending), timestamp(resource), placedAt(time(0)),
+        tableNumber(tableNumber), waiterId(waiterId, resource), subtotalCents(0), taxCents(0) {
+        timestamp = formatDateTime(placedAt);
+    }
+
+    // Archive line: id|table|waiter|timestamp|status|item;item;...
+    std::string toString() const override {
+        std::string line = orderId.toString() + "|" + std::to_string(tableNumber) + "|" + escapeField(getWaiterId())
+            + "|" + escapeField(getTimestamp()) + "|" + std::to_string(static_cast<int>(getStatus())) + "|";
+        for (size_t i = 0; i < items.size(); ++i) {
+            if (i > 0) {
+                line += ";";
+            }
+            line += items[i].toString();
+        }
+        return line;
+    }
+
+    static Order fromString(const std::string& line) {
+        std::vector<std::string> fields = splitFields(line, '|');
+        if (fields.size() != 6) {
+            throw std::invalid_argument("bad order line");
+        }
+
+        Order order(OrderId::parse(fields[0]), std::stoi(fields[1]), unescapeField(fields[2]));
+        if (!order.orderId.isValid()) {
+            throw std::invalid_argument("bad order id");
+        }
+        order.timestamp = unescapeField(fields[3]);
+        order.placedAt = parseDateTime(fields[3]);
+        order.status.store(static_cast<OrderStatus>(std::stoi(fields[4])));
+        if (!fields[5].empty()) {
+            for (const auto& itemText : splitFields(fields[5], ';')) {
+                order.items.push_back(OrderItem::fromString(itemText));
+            }
+        }
+        order.recalculateTotals();
+        return order;
     }
 
+    // Most tickets have only a few lines; sizing for them up front avoids the
+    // 1 -> 2 -> 4 regrowth, whose old buffers an arena can't reuse
+    static const size_t TYPICAL_ITEM_COUNT = 4;
+
     void addItem(const OrderItem& item) {
+        if (items.capacity() == 0) {
+            items.reserve(TYPICAL_ITEM_COUNT);
+        }
         items.push_back(item);
+        subtotalCents += item.getSubtotalCents();
+        refreshTax();
+    }
+
+    // Build the line in place, in the order's own memory resource
+    void addItem(const MenuItem* menuItem, int quantity, const std::string& specialInstructions) {
+        if (items.capacity() == 0) {
+            items.reserve(TYPICAL_ITEM_COUNT);
+        }
+        items.emplace_back(menuItem, quantity, specialInstructions);
+        subtotalCents += items.back().getSubtotalCents();
+        refreshTax();
+    }
+
+    // Change the quantity of an existing line
+    bool updateItemQuantity(size_t index, int newQuantity) {
+        if (index >= items.size() || newQuantity <= 0) {
+            return false;
+        }
+        subtotalCents -= items[index].getSubtotalCents();
+        items[index].setQuantity(newQuantity);
+        subtotalCents += items[index].getSubtotalCents();
+        refreshTax();
+        return true;
+    }
+
+    // Replace the price snapshot of a line (e.g. a comp or a manager override)
+    bool updateItemPrice(size_t index, double newPrice) {
+        if (index >= items.size() || newPrice < 0) {
+            return false;
+        }
+        subtotalCents -= items[index].getSubtotalCents();
+        items[index].setUnitPrice(newPrice);
+        subtotalCents += items[index].getSubtotalCents();
+        refreshTax();
+        return true;
     }
 
-    void updateStatus(OrderStatus newStatus) {
-        status = newStatus;
+    // Remove a line from the order
+    bool voidItem(size_t index) {
+        if (index >= items.size()) {
+            return false;
+        }
+        subtotalCents -= items[index].getSubtotalCents();
+        items.erase(items.begin() + index);
+        refreshTax();
+        return true;
     }
 
-    double getTotal() const {
-        double total = 0.0;
+    // Full rebuild of the cached totals from the item lines
+    void recalculateTotals() {
+        subtotalCents = 0;
         for (const auto& item : items) {
-            total += item.getSubtotal();
+            subtotalCents += item.getSubtotalCents();
         }
-        return total;
+        refreshTax();
     }
 
+    double getSubtotal() const { return subtotalCents / 100.0; }
+    double getTax() const { return taxCents / 100.0; }
+    double getTotal() const { return (subtotalCents + taxCents) / 100.0; }
+    long long getSubtotalCents() const { return subtotalCents; }
+    long long getTaxCents() const { return taxCents; }
+
     // Getters
-    std::string getOrderId() const { return orderId; }
-    OrderStatus getStatus() const { return status; }
-    std::string getTimestamp() const { return timestamp; }
+    OrderId getOrderId() const { return orderId; }
+    OrderStatus getStatus() const { return status.load(std::memory_order_acquire); }
+    std::string getTimestamp() const { return std::string(timestamp); }
+    time_t getPlacedAt() const { return placedAt; }
     int getTableNumber() const { return tableNumber; }
-    std::string getWaiterId() const { return waiterId; }
-    const std::vector<OrderItem>& getItems() const { return items; }
+    std::string getWaiterId() const { return std::string(waiterId); }
+    const std::pmr::vector<OrderItem>& getItems() const { return items; }
 
     void display() const {
         std::cout << "Order ID: " << orderId << " | Table: " << tableNumber
@@ -424,7 +1097,7 @@ public:
         }
 
         std::cout << std::string(80, '-') << std::endl;
-        std::cout << "Total: $" << std::fixed << std::setprecision(2) << getTotal() << std::endl;
+        std::cout << "Total: $" << std::fixed << std::setprecision(2) << getSubtotal() << std::endl;
     }
 
     void generateBill() const {
@@ -439,16 +1112,16 @@ public:
         std::cout << std::string(30, '-') << std::endl;
 
         for (const auto& item : items) {
-            std::cout << std::left << std::setw(20) << item.getMenuItem()->getName()
+            std::cout << std::left << std::setw(20) << item.getItemName()
                 << std::setw(5) << item.getQuantity() << "x"
-                << "$" << std::fixed << std::setprecision(2) << item.getMenuItem()->getPrice()
+                << "$" << std::fixed << std::setprecision(2) << item.getUnitPrice()
                 << " = $" << item.getSubtotal() << std::endl;
         }
 
         std::cout << std::string(30, '-') << std::endl;
-        double subtotal = getTotal();
-        double gst = subtotal * 0.15; // 15% GST
-        double total = subtotal + gst;
+        double subtotal = getSubtotal();
+        double gst = getTax();
+        double total = getTotal();
 
         std::cout << std::left << std::setw(20) << "Subtotal:" << "$" << std::fixed << std::setprecision(2) << subtotal << std::endl;
         std::cout << std::left << std::setw(20) << "GST (15%):" << "$" << std::fixed << std::setprecision(2) << gst << std::endl;
@@ -460,83 +1133,2122 @@ public:
     }
 };
 
-// Class for table management
-class Table {
+// Columnar store of completed order lines for analytics. There is one row per
+// order line and each attribute lives in its own contiguous array, so report
+// queries are flat loops over just the columns they need. Item and waiter ids
+// are stored as small integer handles into dictionaries.
+class OrderLineFacts {
 private:
-    int tableNumber;
-    int capacity;
-    bool occupied;
-    std::string reservation;
+    std::vector<uint32_t> itemColumn;
+    std::vector<int32_t> quantityColumn;
+    std::vector<int64_t> unitPriceCentsColumn;
+    std::vector<int64_t> epochColumn;       // Order placement time
+    std::vector<int32_t> tableColumn;
+    std::vector<uint32_t> waiterColumn;
+    std::vector<uint8_t> firstLineColumn;   // 1 on the first line of each order, for counting orders
+
+    std::unordered_map<std::string, uint32_t> itemHandles;
+    std::vector<std::string> itemIds;
+    std::vector<std::string> itemNames;
+    std::unordered_map<std::string, uint32_t> waiterHandles;
+    std::vector<std::string> waiterIds;
+
+    static uint32_t intern(std::unordered_map<std::string, uint32_t>& handles, std::vector<std::string>& values,
+        const std::string& value) {
+        auto it = handles.find(value);
+        if (it != handles.end()) {
+            return it->second;
+        }
+        uint32_t handle = static_cast<uint32_t>(values.size());
+        handles.emplace(value, handle);
+        values.push_back(value);
+        return handle;
+    }
 
 public:
-    Table(int tableNumber, int capacity)
-        : tableNumber(tableNumber), capacity(capacity), occupied(false), reservation("") {
+    struct SalesTotals {
+        long long orderCount;
+        long long subtotalCents;
+    };
+
+    void addLine(const std::string& itemId, const std::string& itemName, int quantity, long long unitPriceCents,
+        time_t placedAt, int tableNumber, const std::string& waiterId, bool firstLineOfOrder) {
+        uint32_t item = intern(itemHandles, itemIds, itemId);
+        if (itemNames.size() < itemIds.size()) {
+            itemNames.push_back(itemName);
+        }
+        itemColumn.push_back(item);
+        quantityColumn.push_back(quantity);
+        unitPriceCentsColumn.push_back(unitPriceCents);
+        epochColumn.push_back(static_cast<int64_t>(placedAt));
+        tableColumn.push_back(tableNumber);
+        waiterColumn.push_back(intern(waiterHandles, waiterIds, waiterId));
+        firstLineColumn.push_back(firstLineOfOrder ? 1 : 0);
     }
 
-    // Getters and setters
-    int getTableNumber() const { return tableNumber; }
-    int getCapacity() const { return capacity; }
-    bool isOccupied() const { return occupied; }
-    std::string getReservation() const { return reservation; }
-
-    void setOccupied(bool status) { occupied = status; }
-    void setReservation(const std::string& reservationInfo) { reservation = reservationInfo; }
-
-    void display() const {
-        std::cout << "Table " << tableNumber << " | Capacity: " << capacity
-            << " | Status: " << (occupied ? "Occupied" : "Available");
+    void addOrder(const Order& order) {
+        bool first = true;
+        for (const auto& item : order.getItems()) {
+            addLine(item.getItemId(), item.getItemName(), item.getQuantity(), toCents(item.getUnitPrice()),
+                order.getPlacedAt(), order.getTableNumber(), order.getWaiterId(), first);
+            first = false;
+        }
+    }
 
-        if (!reservation.empty()) {
-            std::cout << " | Reserved: " << reservation;
+    // Order count and pre-tax sales for orders placed in [from, to)
+    SalesTotals salesBetween(time_t from, time_t to) const {
+        const int64_t lo = from, hi = to;
+        const size_t rows = epochColumn.size();
+        const int64_t* epoch = epochColumn.data();
+        const int32_t* quantity = quantityColumn.data();
+        const int64_t* price = unitPriceCentsColumn.data();
+        const uint8_t* first = firstLineColumn.data();
+
+        long long orderCount = 0, subtotalCents = 0;
+        for (size_t i = 0; i < rows; ++i) {
+            // Branch-free so the compiler can vectorize the loop
+            int64_t inRange = (epoch[i] >= lo) & (epoch[i] < hi);
+            subtotalCents += inRange * quantity[i] * price[i];
+            orderCount += inRange & first[i];
         }
+        return SalesTotals{ orderCount, subtotalCents };
+    }
 
-        std::cout << std::endl;
+    // Quantity sold per item handle for orders placed in [from, to)
+    std::vector<long long> quantityByItem(time_t from, time_t to) const {
+        const int64_t lo = from, hi = to;
+        const size_t rows = epochColumn.size();
+        std::vector<long long> totals(itemIds.size(), 0);
+        for (size_t i = 0; i < rows; ++i) {
+            int64_t inRange = (epochColumn[i] >= lo) & (epochColumn[i] < hi);
+            totals[itemColumn[i]] += inRange * quantityColumn[i];
+        }
+        return totals;
     }
+
+    const std::string& getItemId(uint32_t handle) const { return itemIds[handle]; }
+    const std::string& getItemName(uint32_t handle) const { return itemNames[handle]; }
+    size_t rowCount() const { return epochColumn.size(); }
 };
 
-// Class for reservation
-class Reservation {
+// One row of a "top items" listing
+struct RankedItem {
+    std::string itemId;
+    std::string itemName;
+    long long quantity;
+};
+
+// Item counts over a sliding time window made of fixed-size buckets in a ring.
+// Moving the window forward subtracts the buckets that fall out of it from the
+// running totals, so the totals always describe exactly the window.
+class SlidingItemCounter {
 private:
-    std::string reservationId;
-    std::string customerName;
-    std::string contactNumber;
-    std::string dateTime;
-    int partySize;
-    int tableNumber;
-    bool confirmed;
+    long long bucketSeconds;
+    long long bucketCount;
+    std::vector<std::vector<long long>> buckets; // [ring slot][item handle]
+    std::vector<long long> totals;               // [item handle]
+    long long newestBucket;                      // Absolute bucket number, -1 before the first event
+
+    void advanceTo(long long bucket) {
+        if (newestBucket < 0) {
+            newestBucket = bucket;
+            return;
+        }
+        if (bucket <= newestBucket) {
+            return;
+        }
+        long long steps = std::min(bucket - newestBucket, bucketCount);
+        for (long long step = 1; step <= steps; ++step) {
+            std::vector<long long>& expired = buckets[(newestBucket + step) % bucketCount];
+            for (size_t item = 0; item < expired.size(); ++item) {
+                totals[item] -= expired[item];
+                expired[item] = 0;
+            }
+        }
+        newestBucket = bucket;
+    }
 
 public:
-    Reservation(const std::string& reservationId, const std::string& customerName,
-        const std::string& contactNumber, const std::string& dateTime,
+    SlidingItemCounter(long long bucketSeconds, long long bucketCount)
+        : bucketSeconds(bucketSeconds), bucketCount(bucketCount), buckets(bucketCount), newestBucket(-1) {
+    }
+
+    void add(time_t when, uint32_t item, long long quantity, time_t now) {
+        advanceTo(now / bucketSeconds);
+        long long bucket = when / bucketSeconds;
+        advanceTo(bucket); // Clock skew: an event slightly in the future
+        if (bucket <= newestBucket - bucketCount) {
+            return; // Already outside the window
+        }
+
+        std::vector<long long>& slot = buckets[bucket % bucketCount];
+        if (slot.size() <= item) {
+            slot.resize(item + 1, 0);
+        }
+        if (totals.size() <= item) {
+            totals.resize(item + 1, 0);
+        }
+        slot[item] += quantity;
+        totals[item] += quantity;
+    }
+
+    const std::vector<long long>& counts(time_t now) {
+        advanceTo(now / bucketSeconds);
+        return totals;
+    }
+};
+
+// "What's hot right now": exact per-item counts over the last hour (per-minute
+// buckets), today, and the last 7 days (per-hour buckets). Updated as orders
+// are billed, so asking for the top items never touches the orders. Menus are
+// small enough that exact counters beat an approximate sketch here.
+class PopularItemsTracker {
+public:
+    enum Window { LastHour, Today, LastWeek };
+
+private:
+    std::unordered_map<std::string, uint32_t> itemHandles;
+    std::vector<std::string> itemIds;
+    std::vector<std::string> itemNames;
+
+    SlidingItemCounter lastHour;
+    SlidingItemCounter lastWeek;
+    std::vector<long long> todayCounts;
+    time_t todayStart;
+
+    void rollToday(time_t now) {
+        time_t dayStart = startOfDay(now);
+        if (dayStart != todayStart) {
+            std::fill(todayCounts.begin(), todayCounts.end(), 0);
+            todayStart = dayStart;
+        }
+    }
+
+    uint32_t handleFor(const std::string& itemId, const std::string& itemName) {
+        auto it = itemHandles.find(itemId);
+        if (it != itemHandles.end()) {
+            return it->second;
+        }
+        uint32_t handle = static_cast<uint32_t>(itemIds.size());
+        itemHandles.emplace(itemId, handle);
+        itemIds.push_back(itemId);
+        itemNames.push_back(itemName);
+        todayCounts.push_back(0);
+        return handle;
+    }
+
+public:
+    PopularItemsTracker() : lastHour(60, 60), lastWeek(3600, 24 * 7), todayStart(0) {}
+
+    // Count the lines of a completed order at the time it was placed
+    void recordOrder(const Order& order, time_t now) {
+        rollToday(now);
+        time_t placedAt = order.getPlacedAt();
+        bool placedToday = placedAt >= todayStart && placedAt < startOfDay(now, 1);
+
+        for (const auto& item : order.getItems()) {
+            uint32_t handle = handleFor(item.getItemId(), item.getItemName());
+            lastHour.add(placedAt, handle, item.getQuantity(), now);
+            lastWeek.add(placedAt, handle, item.getQuantity(), now);
+            if (placedToday) {
+                todayCounts[handle] += item.getQuantity();
+            }
+        }
+    }
+
+    std::vector<RankedItem> top(Window window, size_t k, time_t now) {
+        const std::vector<long long>* counts = &todayCounts;
+        if (window == LastHour) {
+            counts = &lastHour.counts(now);
+        }
+        else if (window == LastWeek) {
+            counts = &lastWeek.counts(now);
+        }
+        else {
+            rollToday(now);
+        }
+
+        std::vector<uint32_t> handles;
+        for (uint32_t handle = 0; handle < counts->size(); ++handle) {
+            if ((*counts)[handle] > 0) {
+                handles.push_back(handle);
+            }
+        }
+        size_t shown = std::min(k, handles.size());
+        std::partial_sort(handles.begin(), handles.begin() + shown, handles.end(),
+            [counts](uint32_t a, uint32_t b) { return (*counts)[a] > (*counts)[b]; });
+
+        std::vector<RankedItem> ranked;
+        for (size_t i = 0; i < shown; ++i) {
+            ranked.push_back(RankedItem{ itemIds[handles[i]], itemNames[handles[i]], (*counts)[handles[i]] });
+        }
+        return ranked;
+    }
+};
+
+// Running sales totals for one day, with per-hour buckets
+class DailySales : public TwoCli::stbase {
+public:
+    std::string date; // YYYY-MM-DD
+    long long orderCount;
+    long long subtotalCents;
+    long long gstCents;
+    long long hourlyOrders[24];
+    long long hourlySubtotalCents[24];
+
+    DailySales() : orderCount(0), subtotalCents(0), gstCents(0), hourlyOrders(), hourlySubtotalCents() {}
+
+    void record(const Order& order, int hour) {
+        orderCount++;
+        subtotalCents += order.getSubtotalCents();
+        gstCents += order.getTaxCents();
+        hourlyOrders[hour]++;
+        hourlySubtotalCents[hour] += order.getSubtotalCents();
+    }
+
+    void add(const DailySales& other) {
+        orderCount += other.orderCount;
+        subtotalCents += other.subtotalCents;
+        gstCents += other.gstCents;
+        for (int hour = 0; hour < 24; ++hour) {
+            hourlyOrders[hour] += other.hourlyOrders[hour];
+            hourlySubtotalCents[hour] += other.hourlySubtotalCents[hour];
+        }
+    }
+
+    long long grossCents() const { return subtotalCents + gstCents; }
+    double averageTicket() const { return orderCount > 0 ? subtotalCents / 100.0 / orderCount : 0.0; }
+
+    // date|orders|subtotal|gst|orders,subtotal;... (24 hourly pairs)
+    std::string toString() const override {
+        std::string line = date + "|" + std::to_string(orderCount) + "|" + std::to_string(subtotalCents) + "|"
+            + std::to_string(gstCents) + "|";
+        for (int hour = 0; hour < 24; ++hour) {
+            if (hour > 0) {
+                line += ";";
+            }
+            line += std::to_string(hourlyOrders[hour]) + "," + std::to_string(hourlySubtotalCents[hour]);
+        }
+        return line;
+    }
+
+    static DailySales fromString(const std::string& line) {
+        std::vector<std::string> fields = splitFields(line, '|');
+        if (fields.size() != 5) {
+            throw std::invalid_argument("bad sales line");
+        }
+        DailySales day;
+        day.date = fields[0];
+        day.orderCount = std::stoll(fields[1]);
+        day.subtotalCents = std::stoll(fields[2]);
+        day.gstCents = std::stoll(fields[3]);
+
+        std::vector<std::string> hours = splitFields(fields[4], ';');
+        if (hours.size() != 24) {
+            throw std::invalid_argument("bad hourly buckets");
+        }
+        for (int hour = 0; hour < 24; ++hour) {
+            std::vector<std::string> bucket = splitFields(hours[hour], ',');
+            if (bucket.size() != 2) {
+                throw std::invalid_argument("bad hourly bucket");
+            }
+            day.hourlyOrders[hour] = std::stoll(bucket[0]);
+            day.hourlySubtotalCents[hour] = std::stoll(bucket[1]);
+        }
+        return day;
+    }
+};
+
+// One line of the sales aggregates file: a day's totals carried over from
+// earlier runs (no order id), or one billed order's share of its day.
+class SalesLine : public TwoCli::stbase {
+public:
+    DailySales sales;
+    OrderId orderId; // Invalid on a totals line
+
+    // <DailySales line>[|<order id>]
+    std::string toString() const override {
+        std::string line = sales.toString();
+        return orderId.isValid() ? line + "|" + orderId.toString() : line;
+    }
+
+    static SalesLine fromString(const std::string& line) {
+        SalesLine result;
+        if (std::count(line.begin(), line.end(), '|') == 5) {
+            size_t last = line.rfind('|');
+            result.orderId = OrderId::parse(line.substr(last + 1));
+            if (!result.orderId.isValid()) {
+                throw std::invalid_argument("bad order id");
+            }
+            result.sales = DailySales::fromString(line.substr(0, last));
+        }
+        else {
+            result.sales = DailySales::fromString(line);
+        }
+        return result;
+    }
+};
+
+// Live daily sales totals, updated as each order is billed so the daily report
+// is a single lookup. Every billed order appends its own share of the day to
+// the file, so terminals sharing the file add to each other's totals instead
+// of replacing them. On load a day is its last totals line plus every order
+// line, each order counted once; the file is only ever appended to.
+class SalesAggregates {
+private:
+    TwoCli::FileManager<SalesLine> file;
+    std::map<std::string, DailySales> days;
+    std::vector<SalesLine> unsaved; // Recorded with persist false, for saveAll()
+
+public:
+    explicit SalesAggregates(const std::string& filename) : file(filename) {
+        std::map<std::string, DailySales> orderShares;
+        std::unordered_set<OrderId> counted; // Two terminals rebuilding at once may both write an order
+        for (const auto& line : file.readRecords()) {
+            if (line.orderId.isValid()) {
+                if (!counted.insert(line.orderId).second) {
+                    continue;
+                }
+                DailySales& share = orderShares[line.sales.date];
+                share.date = line.sales.date;
+                share.add(line.sales);
+            }
+            else {
+                days[line.sales.date] = line.sales; // Older files hold running totals; the last is the day's
+            }
+        }
+        for (const auto& share : orderShares) {
+            DailySales& day = days[share.first];
+            day.date = share.first;
+            day.add(share.second);
+        }
+    }
+
+    // Count a completed order against the day and hour it was placed.
+    // Set persist to false when replaying history in bulk and call saveAll() after.
+    void recordCompletion(const Order& order, bool persist = true) {
+        time_t placedAt = order.getPlacedAt();
+        struct tm local = toLocalTime(placedAt);
+        std::string date = formatDateTime(placedAt).substr(0, 10);
+
+        DailySales& day = days[date];
+        day.date = date;
+        day.record(order, local.tm_hour);
+
+        SalesLine line;
+        line.sales.date = date;
+        line.sales.record(order, local.tm_hour);
+        line.orderId = order.getOrderId();
+        if (persist) {
+            file.appendRecord(line);
+        }
+        else {
+            unsaved.push_back(line);
+        }
+    }
+
+    const DailySales* getDay(const std::string& date) const {
+        auto it = days.find(date);
+        return it != days.end() ? &it->second : nullptr;
+    }
+
+    bool saveAll() {
+        bool saved = file.appendRecords(unsaved);
+        unsaved.clear();
+        return saved;
+    }
+
+    bool empty() const { return days.empty(); }
+};
+
+// Cold tier: append-only file of orders that reached Completed or Cancelled.
+// Only an id -> file offset index is kept in memory.
+class OrderArchive {
+private:
+    TwoCli::FileManager<Order> file;
+    std::unordered_map<OrderId, long long> offsets;
+    std::unordered_map<unsigned, unsigned long long> highestSequence; // Per issuing terminal
+
+    void remember(OrderId orderId, long long offset) {
+        offsets[orderId] = offset;
+        unsigned long long& highest = highestSequence[orderId.getTerminal()];
+        if (orderId.getSequence() > highest) {
+            highest = orderId.getSequence();
+        }
+    }
+
+public:
+    explicit OrderArchive(const std::string& filename) : file(filename) {
+        file.forEachRecord([this](const Order& order, long long offset) {
+            remember(order.getOrderId(), offset);
+            });
+    }
+
+    bool append(const Order& order) {
+        long long offset = file.appendRecord(order);
+        if (offset < 0) {
+            return false;
+        }
+        remember(order.getOrderId(), offset);
+        return true;
+    }
+
+    bool contains(OrderId orderId) const {
+        return offsets.count(orderId) > 0;
+    }
+
+    bool load(OrderId orderId, Order& out) {
+        auto it = offsets.find(orderId);
+        return it != offsets.end() && file.readRecordAt(it->second, out);
+    }
+
+    // Streams the archive from disk in the order orders were closed
+    template<typename Func>
+    void forEach(Func fn) {
+        file.forEachRecord([&fn](const Order& order, long long) { fn(order); });
+    }
+
+    unsigned long long getHighestSequence(unsigned terminal) const {
+        auto it = highestSequence.find(terminal);
+        return it != highestSequence.end() ? it->second : 0;
+    }
+
+    size_t size() const { return offsets.size(); }
+};
+
+// Hot tier: open orders with a hash index on order id plus secondary indexes by
+// table, status and waiter. Each index bucket is keyed by placement sequence so
+// that listings come out in the order the tickets were taken. Orders that reach
+// Completed or Cancelled are moved to the OrderArchive, so the hot set stays the
+// size of the tickets currently on the floor.
+class OrderRepository {
+private:
+    typedef std::map<unsigned long long, Order*> Bucket;
+
+    struct Entry {
+        Order order;
+        unsigned long long sequence;
+    };
+
+    std::unordered_map<OrderId, Entry> byId;
+    Bucket placement;                               // every order
+    std::unordered_map<int, Bucket> openByTable;    // only orders not yet Completed/Cancelled
+    std::map<OrderStatus, Bucket> byStatus;
+    std::unordered_map<std::string, Bucket> byWaiter;
+    unsigned long long nextSequence;
+    OrderArchive* archive;
+    std::atomic<unsigned long long> rejected[ORDER_STATUS_COUNT][ORDER_STATUS_COUNT]; // by from/to status
+
+    static bool isOpen(OrderStatus status) {
+        return status != OrderStatus::Completed && status != OrderStatus::Cancelled;
+    }
+
+    static std::vector<Order*> toList(const Bucket* bucket) {
+        std::vector<Order*> result;
+        if (bucket != nullptr) {
+            result.reserve(bucket->size());
+            for (const auto& entry : *bucket) {
+                result.push_back(entry.second);
+            }
+        }
+        return result;
+    }
+
+    template<typename Key, typename Map>
+    static const Bucket* findBucket(const Map& index, const Key& key) {
+        auto it = index.find(key);
+        return it != index.end() ? &it->second : nullptr;
+    }
+
+    template<typename Key, typename Map>
+    static void removeFromBucket(Map& index, const Key& key, unsigned long long sequence) {
+        auto it = index.find(key);
+        if (it != index.end()) {
+            it->second.erase(sequence);
+            if (it->second.empty()) {
+                index.erase(it);
+            }
+        }
+    }
+
+    // Move a closed order out of the hot set into the archive; closedOrder, if
+    // given, takes the order itself
+    bool evict(std::unordered_map<OrderId, Entry>::iterator it, std::optional<Order>* closedOrder = nullptr) {
+        Order& order = it->second.order;
+        if (!archive->append(order)) {
+            return false; // Keep it hot rather than lose it
+        }
+
+        unsigned long long sequence = it->second.sequence;
+        removeFromBucket(byStatus, order.getStatus(), sequence);
+        removeFromBucket(byWaiter, order.getWaiterId(), sequence);
+        removeFromBucket(openByTable, order.getTableNumber(), sequence);
+        placement.erase(sequence);
+        if (closedOrder != nullptr) {
+            closedOrder->emplace(std::move(order));
+        }
+        byId.erase(it);
+        return true;
+    }
+
+public:
+    explicit OrderRepository(OrderArchive& archive) : nextSequence(1), archive(&archive) {
+        for (auto& row : rejected) {
+            for (auto& count : row) {
+                count.store(0);
+            }
+        }
+    }
+
+    // Take ownership of a new order and index it
+    Order& add(Order order) {
+        OrderId orderId = order.getOrderId();
+        unsigned long long sequence = nextSequence++;
+        auto result = byId.emplace(orderId, Entry{ std::move(order), sequence });
+        Order* stored = &result.first->second.order;
+
+        placement[sequence] = stored;
+        byStatus[stored->getStatus()][sequence] = stored;
+        byWaiter[stored->getWaiterId()][sequence] = stored;
+        if (isOpen(stored->getStatus())) {
+            openByTable[stored->getTableNumber()][sequence] = stored;
+        }
+        return *stored;
+    }
+
+    Order* find(OrderId orderId) {
+        auto it = byId.find(orderId);
+        return it != byId.end() ? &it->second.order : nullptr;
+    }
+
+    const Order* find(OrderId orderId) const {
+        auto it = byId.find(orderId);
+        return it != byId.end() ? &it->second.order : nullptr;
+    }
+
+    // The only way to change an order's status; keeps every index consistent.
+    // Fails for unknown orders and for changes the lifecycle does not allow,
+    // such as serving an order twice or reopening a billed one. changed, if
+    // given, receives the order as it stood right after the change.
+    bool updateStatus(OrderId orderId, OrderStatus newStatus, std::optional<Order>* changed = nullptr) {
+        auto it = byId.find(orderId);
+        if (it == byId.end()) {
+            return false;
+        }
+
+        Order& order = it->second.order;
+        unsigned long long sequence = it->second.sequence;
+        OrderStatus oldStatus;
+        if (!order.transitionStatus(newStatus, oldStatus)) {
+            rejected[static_cast<int>(oldStatus)][static_cast<int>(newStatus)].fetch_add(1, std::memory_order_relaxed);
+            return false;
+        }
+
+        removeFromBucket(byStatus, oldStatus, sequence);
+        byStatus[newStatus][sequence] = &order;
+
+        if (isOpen(oldStatus) && !isOpen(newStatus)) {
+            removeFromBucket(openByTable, order.getTableNumber(), sequence);
+        }
+        else if (!isOpen(oldStatus) && isOpen(newStatus)) {
+            openByTable[order.getTableNumber()][sequence] = &order;
+        }
+
+        if (!isOpen(newStatus) && evict(it, changed)) {
+            return true;
+        }
+        if (changed != nullptr) {
+            changed->emplace(order);
+        }
+        return true;
+    }
+
+    // How often a change from one status to another was refused
+    unsigned long long rejectedTransitions(OrderStatus from, OrderStatus to) const {
+        return rejected[static_cast<int>(from)][static_cast<int>(to)].load(std::memory_order_relaxed);
+    }
+
+    unsigned long long rejectedTransitionCount() const {
+        unsigned long long total = 0;
+        for (const auto& row : rejected) {
+            for (const auto& count : row) {
+                total += count.load(std::memory_order_relaxed);
+            }
+        }
+        return total;
+    }
+
+    // Run fn on an order from whichever tier holds it
+    template<typename Func>
+    bool visit(OrderId orderId, Func fn) const {
+        const Order* order = find(orderId);
+        if (order != nullptr) {
+            fn(*order);
+            return true;
+        }
+        Order archived;
+        if (archive->load(orderId, archived)) {
+            fn(static_cast<const Order&>(archived));
+            return true;
+        }
+        return false;
+    }
+
+    // Run fn on every order in a status, across both tiers
+    template<typename Func>
+    void forEachInStatus(OrderStatus status, Func fn) const {
+        if (!isOpen(status)) {
+            archive->forEach([status, &fn](const Order& order) {
+                if (order.getStatus() == status) {
+                    fn(order);
+                }
+                });
+        }
+        for (const Order* order : findByStatus(status)) {
+            fn(*order);
+        }
+    }
+
+    // Run fn on every order across both tiers, archived ones first
+    template<typename Func>
+    void forEachOrder(Func fn) const {
+        archive->forEach(fn);
+        for (const auto& entry : placement) {
+            fn(static_cast<const Order&>(*entry.second));
+        }
+    }
+
+    std::vector<Order*> findByStatus(OrderStatus status) const {
+        return toList(findBucket(byStatus, status));
+    }
+
+    // Orders in any of the given statuses, still in placement order
+    std::vector<Order*> findByStatus(std::initializer_list<OrderStatus> statuses) const {
+        std::vector<std::pair<unsigned long long, Order*>> merged;
+        for (OrderStatus status : statuses) {
+            const Bucket* bucket = findBucket(byStatus, status);
+            if (bucket != nullptr) {
+                merged.insert(merged.end(), bucket->begin(), bucket->end());
+            }
+        }
+        std::sort(merged.begin(), merged.end(),
+            [](const std::pair<unsigned long long, Order*>& a, const std::pair<unsigned long long, Order*>& b) {
+                return a.first < b.first;
+            });
+
+        std::vector<Order*> result;
+        result.reserve(merged.size());
+        for (const auto& entry : merged) {
+            result.push_back(entry.second);
+        }
+        return result;
+    }
+
+    std::vector<Order*> findOpenByTable(int tableNumber) const {
+        return toList(findBucket(openByTable, tableNumber));
+    }
+
+    std::vector<Order*> findByWaiter(const std::string& waiterId) const {
+        return toList(findBucket(byWaiter, waiterId));
+    }
+
+    std::vector<Order*> all() const {
+        return toList(&placement);
+    }
+
+    size_t size() const { return byId.size(); }
+    bool empty() const { return byId.empty(); }
+    size_t archivedCount() const { return archive->size(); }
+};
+
+// Class for table management
+class Table {
+private:
+    int tableNumber;
+    int capacity;
+    bool occupied;
+    std::string reservation;
+
+public:
+    Table(int tableNumber, int capacity)
+        : tableNumber(tableNumber), capacity(capacity), occupied(false), reservation("") {
+    }
+
+    // Getters and setters
+    int getTableNumber() const { return tableNumber; }
+    int getCapacity() const { return capacity; }
+    bool isOccupied() const { return occupied; }
+    std::string getReservation() const { return reservation; }
+
+    void setOccupied(bool status) { occupied = status; }
+    void setReservation(const std::string& reservationInfo) { reservation = reservationInfo; }
+
+    void display() const {
+        std::cout << "Table " << tableNumber << " | Capacity: " << capacity
+            << " | Status: " << (occupied ? "Occupied" : "Available");
+
+        if (!reservation.empty()) {
+            std::cout << " | Reserved: " << reservation;
+        }
+
+        std::cout << std::endl;
+    }
+};
+
+// The 64-bit MSVC intrinsics exist only on 64-bit targets; 32-bit builds count each half
+inline int countSetBits(uint64_t word) {
+#if defined(_MSC_VER) && defined(_M_X64)
+    return static_cast<int>(__popcnt64(word));
+#elif defined(_MSC_VER) && defined(_M_ARM64)
+    return static_cast<int>(_CountOneBits64(word));
+#elif defined(_MSC_VER)
+    return static_cast<int>(__popcnt(static_cast<unsigned int>(word)) + __popcnt(static_cast<unsigned int>(word >> 32)));
+#else
+    return __builtin_popcountll(word);
+#endif
+}
+
+// Table availability as bitsets over table slots (positions in the table list):
+// one bit per table for occupied and reserved, and one bitset per capacity
+// class. Availability queries combine whole 64-bit words instead of scanning
+// Table objects, and tables are found by number through a direct lookup.
+class TableAvailability {
+private:
+    typedef std::vector<uint64_t> Bits;
+
+    size_t wordCount;
+    Bits occupied;
+    Bits reserved;
+    std::map<int, Bits> byCapacity;  // capacity -> tables with exactly that many seats
+    std::vector<int> slotByNumber;   // table number -> slot, -1 if there is no such table
+    std::vector<int> numberBySlot;
+
+    static void setBit(Bits& bits, int slot, bool value) {
+        uint64_t mask = uint64_t(1) << (slot % 64);
+        if (value) {
+            bits[slot / 64] |= mask;
+        }
+        else {
+            bits[slot / 64] &= ~mask;
+        }
+    }
+
+    // Free (and optionally unreserved) tables in one capacity class, word 'w'
+    uint64_t freeWord(const Bits& capacityClass, size_t w, bool includeReserved) const {
+        uint64_t word = capacityClass[w] & ~occupied[w];
+        return includeReserved ? word : word & ~reserved[w];
+    }
+
+public:
+    explicit TableAvailability(const std::vector<Table>& tables)
+        : wordCount((tables.size() + 63) / 64), occupied(wordCount), reserved(wordCount) {
+        for (size_t slot = 0; slot < tables.size(); ++slot) {
+            int number = tables[slot].getTableNumber();
+            if (number >= static_cast<int>(slotByNumber.size())) {
+                slotByNumber.resize(number + 1, -1);
+            }
+            slotByNumber[number] = static_cast<int>(slot);
+            numberBySlot.push_back(number);
+
+            Bits& capacityClass = byCapacity[tables[slot].getCapacity()];
+            capacityClass.resize(wordCount);
+            setBit(capacityClass, static_cast<int>(slot), true);
+            setBit(occupied, static_cast<int>(slot), tables[slot].isOccupied());
+            setBit(reserved, static_cast<int>(slot), !tables[slot].getReservation().empty());
+        }
+    }
+
+    // Slot of a table number, or -1 if there is no such table
+    int slotOf(int tableNumber) const {
+        if (tableNumber < 0 || tableNumber >= static_cast<int>(slotByNumber.size())) {
+            return -1;
+        }
+        return slotByNumber[tableNumber];
+    }
+
+    bool isOccupied(int slot) const { return (occupied[slot / 64] >> (slot % 64)) & 1; }
+    void setOccupied(int slot, bool value) { setBit(occupied, slot, value); }
+    void setReserved(int slot, bool value) { setBit(reserved, slot, value); }
+
+    int occupiedCount() const {
+        int count = 0;
+        for (uint64_t word : occupied) {
+            count += countSetBits(word);
+        }
+        return count;
+    }
+
+    // Tables with a reservation that nobody is sitting at yet
+    int reservedNotOccupiedCount() const {
+        int count = 0;
+        for (size_t w = 0; w < wordCount; ++w) {
+            count += countSetBits(reserved[w] & ~occupied[w]);
+        }
+        return count;
+    }
+
+    // Capacity classes with their number of free tables
+    std::vector<std::pair<int, int>> freeCountsByCapacity() const {
+        std::vector<std::pair<int, int>> counts;
+        for (const auto& capacityClass : byCapacity) {
+            int count = 0;
+            for (size_t w = 0; w < wordCount; ++w) {
+                count += countSetBits(freeWord(capacityClass.second, w, true));
+            }
+            counts.push_back(std::make_pair(capacityClass.first, count));
+        }
+        return counts;
+    }
+};
+
+enum class ReservationStatus {
+    Confirmed,
+    Seated,
+    Cancelled,
+    NoShow
+};
+
+std::string reservationStatusToString(ReservationStatus status) {
+    switch (status) {
+    case ReservationStatus::Confirmed: return "Confirmed";
+    case ReservationStatus::Seated: return "Seated";
+    case ReservationStatus::Cancelled: return "Cancelled";
+    case ReservationStatus::NoShow: return "No-show";
+    default: return "Unknown";
+    }
+}
+
+// Class for reservation
+class Reservation {
+private:
+    ReservationId reservationId;
+    std::string customerName;
+    std::string contactNumber;
+    std::string dateTime;
+    time_t startTime;
+    int partySize;
+    int tableNumber;
+    ReservationStatus status;
+
+public:
+    Reservation(ReservationId reservationId, const std::string& customerName,
+        const std::string& contactNumber, time_t startTime,
         int partySize, int tableNumber)
         : reservationId(reservationId), customerName(customerName), contactNumber(contactNumber),
-        dateTime(dateTime), partySize(partySize), tableNumber(tableNumber), confirmed(true) {
+        dateTime(formatDateTime(startTime).substr(0, 16)), startTime(startTime),
+        partySize(partySize), tableNumber(tableNumber), status(ReservationStatus::Confirmed) {
+    }
+
+    // Getters
+    ReservationId getReservationId() const { return reservationId; }
+    std::string getCustomerName() const { return customerName; }
+    std::string getContactNumber() const { return contactNumber; }
+    std::string getDateTime() const { return dateTime; }
+    time_t getStartTime() const { return startTime; }
+    int getPartySize() const { return partySize; }
+    int getTableNumber() const { return tableNumber; }
+    ReservationStatus getStatus() const { return status; }
+    bool isConfirmed() const { return status == ReservationStatus::Confirmed; }
+
+    void setStatus(ReservationStatus newStatus) { status = newStatus; }
+
+    void display() const {
+        std::cout << "Reservation ID: " << reservationId
+            << " | Customer: " << customerName
+            << " | Contact: " << contactNumber
+            << " | Date/Time: " << dateTime
+            << " | Party Size: " << partySize
+            << " | Table: " << tableNumber
+            << " | Status: " << reservationStatusToString(status)
+            << std::endl;
+    }
+
+    std::string getReservationInfo() const {
+        return customerName + " (" + dateTime + ", " + std::to_string(partySize) + " people)";
+    }
+};
+
+// Live reservations with hashed lookup by id and by phone number, and
+// prefix lookup by customer name. Entries live in one dense vector; a
+// cancelled or expired reservation is swapped with the last entry and
+// popped, so storage and scans only ever cover live bookings.
+class ReservationBook {
+private:
+    std::vector<Reservation> entries;
+    std::unordered_map<ReservationId, size_t> indexById;
+    std::unordered_map<std::string, std::vector<ReservationId>> idsByPhone;
+    std::multimap<std::string, ReservationId> idsByName; // Lower-case name, kept sorted for prefix search
+
+    static void eraseId(std::vector<ReservationId>& ids, ReservationId id) {
+        ids.erase(std::remove(ids.begin(), ids.end(), id), ids.end());
+    }
+
+    void removeAt(size_t index) {
+        const Reservation& gone = entries[index];
+        ReservationId id = gone.getReservationId();
+
+        auto phone = idsByPhone.find(normalizePhone(gone.getContactNumber()));
+        if (phone != idsByPhone.end()) {
+            eraseId(phone->second, id);
+            if (phone->second.empty()) {
+                idsByPhone.erase(phone);
+            }
+        }
+        auto names = idsByName.equal_range(normalizeName(gone.getCustomerName()));
+        for (auto it = names.first; it != names.second; ++it) {
+            if (it->second == id) {
+                idsByName.erase(it);
+                break;
+            }
+        }
+
+        // Swap and pop, then repoint the moved entry
+        if (index != entries.size() - 1) {
+            entries[index] = std::move(entries.back());
+            indexById[entries[index].getReservationId()] = index;
+        }
+        entries.pop_back();
+        indexById.erase(id);
+    }
+
+public:
+    // Digits only, keeping a leading '+', so "+64 21-123 4567" and "+64211234567" match
+    static std::string normalizePhone(const std::string& phone) {
+        std::string digits;
+        for (char c : phone) {
+            if (std::isdigit(static_cast<unsigned char>(c)) || (c == '+' && digits.empty())) {
+                digits += c;
+            }
+        }
+        return digits;
+    }
+
+    static std::string normalizeName(const std::string& name) {
+        std::string lower;
+        for (char c : name) {
+            if (!std::isspace(static_cast<unsigned char>(c)) || !lower.empty()) {
+                lower += static_cast<char>(std::tolower(static_cast<unsigned char>(c)));
+            }
+        }
+        while (!lower.empty() && std::isspace(static_cast<unsigned char>(lower.back()))) {
+            lower.pop_back();
+        }
+        return lower;
+    }
+
+    void add(const Reservation& reservation) {
+        ReservationId id = reservation.getReservationId();
+        indexById[id] = entries.size();
+        idsByPhone[normalizePhone(reservation.getContactNumber())].push_back(id);
+        idsByName.insert(std::make_pair(normalizeName(reservation.getCustomerName()), id));
+        entries.push_back(reservation);
+    }
+
+    const Reservation* find(ReservationId id) const {
+        auto it = indexById.find(id);
+        return it == indexById.end() ? nullptr : &entries[it->second];
+    }
+
+    Reservation* find(ReservationId id) {
+        auto it = indexById.find(id);
+        return it == indexById.end() ? nullptr : &entries[it->second];
+    }
+
+    std::vector<const Reservation*> findByPhone(const std::string& phone) const {
+        std::vector<const Reservation*> found;
+        auto it = idsByPhone.find(normalizePhone(phone));
+        if (it != idsByPhone.end()) {
+            for (ReservationId id : it->second) {
+                found.push_back(find(id));
+            }
+        }
+        return found;
+    }
+
+    // Reservations whose customer name starts with 'prefix', ignoring case
+    std::vector<const Reservation*> findByNamePrefix(const std::string& prefix) const {
+        std::vector<const Reservation*> found;
+        std::string key = normalizeName(prefix);
+        for (auto it = idsByName.lower_bound(key); it != idsByName.end() && it->first.compare(0, key.size(), key) == 0; ++it) {
+            found.push_back(find(it->second));
+        }
+        return found;
+    }
+
+    bool remove(ReservationId id) {
+        auto it = indexById.find(id);
+        if (it == indexById.end()) {
+            return false;
+        }
+        removeAt(it->second);
+        return true;
+    }
+
+    // Drop reservations that started before 'cutoff'; returns how many went
+    size_t removeStartedBefore(time_t cutoff) {
+        size_t removed = 0;
+        for (size_t i = 0; i < entries.size();) {
+            if (entries[i].getStartTime() < cutoff) {
+                removeAt(i);
+                removed++;
+            }
+            else {
+                ++i;
+            }
+        }
+        return removed;
+    }
+
+    // All live reservations in start time order
+    std::vector<const Reservation*> byStartTime() const {
+        std::vector<const Reservation*> sorted;
+        for (const auto& reservation : entries) {
+            sorted.push_back(&reservation);
+        }
+        std::sort(sorted.begin(), sorted.end(), [](const Reservation* a, const Reservation* b) {
+            return a->getStartTime() < b->getStartTime();
+        });
+        return sorted;
+    }
+
+    size_t size() const { return entries.size(); }
+    bool empty() const { return entries.empty(); }
+};
+
+// Bookings per table as 15-minute slot bitmaps. Slots are counted from the
+// epoch and grouped into blocks of 96 (one UTC day), so a booking is a run
+// of bits and checking or claiming it touches one or two words per block.
+// Blocks are created on first use and pruned once they are in the past.
+class ReservationCalendar {
+public:
+    static const int SLOT_MINUTES = 15;
+    static const int DEFAULT_DURATION_MINUTES = 90;
+
+    struct Opening {
+        int tableNumber;  // -1 if nothing was found
+        time_t start;
+    };
+
+private:
+    static const time_t SLOT_SECONDS = SLOT_MINUTES * 60;
+    static const long long SLOTS_PER_BLOCK = 96;
+
+    struct DayBits {
+        uint64_t words[2];
+    };
+
+    std::vector<int> numberBySlot;
+    std::vector<int> slotByNumber;  // table number -> slot, -1 if there is no such table
+    std::vector<int> capacityBySlot;
+    std::vector<int> slotsBySize;  // Table slots ordered by capacity, then table number
+    std::unordered_map<long long, std::vector<DayBits>> blocks;  // block -> bits per table
+    std::vector<std::map<time_t, std::string>> bookings;  // Per table: start -> label
+
+    static long long slotOf(time_t when) { return static_cast<long long>(when / SLOT_SECONDS); }
+
+    static int slotCount(int minutes) { return std::max(1, (minutes + SLOT_MINUTES - 1) / SLOT_MINUTES); }
+
+    // Mask for bits [first, first + count) of one 64-bit word
+    static uint64_t runMask(int first, int count) {
+        uint64_t bits = count >= 64 ? ~uint64_t(0) : ((uint64_t(1) << count) - 1);
+        return bits << first;
+    }
+
+    // Apply fn(word, mask) to every word covering slots [first, first + count) of one table
+    template<typename Fn>
+    bool forEachWord(int table, long long first, int count, bool create, Fn fn) {
+        while (count > 0) {
+            long long block = first / SLOTS_PER_BLOCK;
+            int offset = static_cast<int>(first % SLOTS_PER_BLOCK);
+            // Stop at the end of the word and of the block; bits 32-63 of the second word are unused
+            int inWord = std::min({ count, 64 - offset % 64, static_cast<int>(SLOTS_PER_BLOCK - offset) });
+            auto it = blocks.find(block);
+            if (it == blocks.end()) {
+                if (!create) {
+                    first += inWord;
+                    count -= inWord;
+                    continue;  // No bookings that day: all free
+                }
+                it = blocks.emplace(block, std::vector<DayBits>(numberBySlot.size(), DayBits{ { 0, 0 } })).first;
+            }
+            if (!fn(it->second[table].words[offset / 64], runMask(offset % 64, inWord))) {
+                return false;
+            }
+            first += inWord;
+            count -= inWord;
+        }
+        return true;
+    }
+
+    bool isFree(int table, long long first, int count) {
+        return forEachWord(table, first, count, false,
+            [](uint64_t& word, uint64_t mask) { return (word & mask) == 0; });
+    }
+
+public:
+    explicit ReservationCalendar(const std::vector<Table>& tables) : bookings(tables.size()) {
+        for (const auto& table : tables) {
+            if (table.getTableNumber() >= static_cast<int>(slotByNumber.size())) {
+                slotByNumber.resize(table.getTableNumber() + 1, -1);
+            }
+            slotByNumber[table.getTableNumber()] = static_cast<int>(numberBySlot.size());
+            slotsBySize.push_back(static_cast<int>(numberBySlot.size()));
+            numberBySlot.push_back(table.getTableNumber());
+            capacityBySlot.push_back(table.getCapacity());
+        }
+        std::stable_sort(slotsBySize.begin(), slotsBySize.end(),
+            [this](int a, int b) { return capacityBySlot[a] < capacityBySlot[b]; });
+    }
+
+    // Start times are rounded down to the slot they fall in
+    static time_t slotStart(time_t when) { return when - when % SLOT_SECONDS; }
+
+    // Smallest table seating partySize that is free for the whole booking, or -1
+    int findTable(int partySize, time_t start, int minutes = DEFAULT_DURATION_MINUTES) {
+        long long first = slotOf(start);
+        int count = slotCount(minutes);
+        for (int table : slotsBySize) {
+            if (capacityBySlot[table] >= partySize && isFree(table, first, count)) {
+                return numberBySlot[table];
+            }
+        }
+        return -1;
+    }
+
+    // Closest start to 'target' (earlier or later, within 'windowMinutes') with a
+    // table free for the whole booking; ties go to the later slot
+    Opening nextAvailable(int partySize, time_t target, int windowMinutes = 180,
+        int minutes = DEFAULT_DURATION_MINUTES, time_t notBefore = 0) {
+        time_t base = slotStart(target);
+        for (int step = 0; step <= windowMinutes / SLOT_MINUTES; ++step) {
+            const time_t candidates[] = { base + step * SLOT_SECONDS, base - step * SLOT_SECONDS };
+            for (int i = 0; i < (step == 0 ? 1 : 2); ++i) {
+                if (candidates[i] < notBefore) {
+                    continue;
+                }
+                int tableNumber = findTable(partySize, candidates[i], minutes);
+                if (tableNumber != -1) {
+                    return Opening{ tableNumber, candidates[i] };
+                }
+            }
+        }
+        return Opening{ -1, 0 };
+    }
+
+    // Claim the slots on a table; fails if any of them is taken
+    bool book(int tableNumber, time_t start, const std::string& label, int minutes = DEFAULT_DURATION_MINUTES) {
+        int table = tableIndex(tableNumber);
+        long long first = slotOf(start);
+        int count = slotCount(minutes);
+        if (table < 0 || !isFree(table, first, count)) {
+            return false;
+        }
+        forEachWord(table, first, count, true, [](uint64_t& word, uint64_t mask) { word |= mask; return true; });
+        bookings[table][slotStart(start)] = label;
+        return true;
+    }
+
+    bool isTableFree(int tableNumber, time_t start, int minutes = DEFAULT_DURATION_MINUTES) {
+        int table = tableIndex(tableNumber);
+        return table >= 0 && isFree(table, slotOf(start), slotCount(minutes));
+    }
+
+    void release(int tableNumber, time_t start, int minutes = DEFAULT_DURATION_MINUTES) {
+        int table = tableIndex(tableNumber);
+        if (table < 0) {
+            return;
+        }
+        forEachWord(table, slotOf(start), slotCount(minutes), false,
+            [](uint64_t& word, uint64_t mask) { word &= ~mask; return true; });
+        bookings[table].erase(slotStart(start));
+    }
+
+    // Label of the first booking on a table that hasn't ended by 'now', or ""
+    std::string nextBooking(int tableNumber, time_t now) const {
+        int table = tableIndex(tableNumber);
+        if (table < 0) {
+            return "";
+        }
+        auto it = bookings[table].lower_bound(now - DEFAULT_DURATION_MINUTES * 60 + 1);
+        return it == bookings[table].end() ? "" : it->second;
+    }
+
+    // Drop bitmaps and bookings for days that are over
+    void pruneBefore(time_t when) {
+        long long currentBlock = slotOf(when) / SLOTS_PER_BLOCK;
+        for (auto it = blocks.begin(); it != blocks.end();) {
+            it = (it->first < currentBlock - 1) ? blocks.erase(it) : std::next(it);
+        }
+        for (auto& tableBookings : bookings) {
+            tableBookings.erase(tableBookings.begin(), tableBookings.lower_bound(when - 24 * 3600));
+        }
+    }
+
+    int tableIndex(int tableNumber) const {
+        if (tableNumber < 0 || tableNumber >= static_cast<int>(slotByNumber.size())) {
+            return -1;
+        }
+        return slotByNumber[tableNumber];
+    }
+};
+
+// Seats a batch of waiting parties at the free tables in one decision.
+// A party can take one table or two adjacent ones (table n with n + 1).
+// Plans seat as many guests as possible, then leave as few seats unused
+// at the tables they take. bestFit() is a greedy pass, largest party
+// first; exact() is a branch and bound search that starts from that plan
+// and stops at a time budget.
+class SeatingOptimizer {
+public:
+    struct Party {
+        int id;    // Caller's identifier, e.g. waitlist position
+        int size;
+    };
+
+    struct FreeTable {
+        int tableNumber;
+        int capacity;
+    };
+
+    struct Placement {
+        int partyId;
+        int firstTable;
+        int secondTable;  // -1 unless two tables are combined
+        int seats;
+    };
+
+    struct Plan {
+        std::vector<Placement> placements;
+        int seatedGuests = 0;
+        int unusedSeats = 0;
+        bool optimal = false;  // Exact search finished within its budget
+        long long nodes = 0;
+        double millis = 0.0;
+    };
+
+private:
+    struct Option {
+        int first;   // Index into freeTables
+        int second;  // -1 for a single table
+        int capacity;
+    };
+
+    std::vector<FreeTable> freeTables;
+    std::vector<Party> parties;  // Largest first
+    std::vector<Option> options; // Smallest first, single tables before combined ones
+
+    Placement placementFor(const Party& party, const Option& option) const {
+        return Placement{ party.id, freeTables[option.first].tableNumber,
+            option.second < 0 ? -1 : freeTables[option.second].tableNumber, option.capacity };
+    }
+
+    struct Search {
+        std::vector<char> used;
+        std::vector<Placement> current;
+        std::vector<int> guestsFrom;  // Guests in parties[i..]
+        Plan best;
+        long long nodes = 0;
+        bool timedOut = false;
+        std::chrono::steady_clock::time_point deadline;
+    };
+
+    void branch(Search& search, size_t i, int seated, int unused, int freeSeats) const {
+        if ((++search.nodes & 1023) == 0 && std::chrono::steady_clock::now() > search.deadline) {
+            search.timedOut = true;
+        }
+        if (search.timedOut) {
+            return;
+        }
+
+        // Even seating everyone left can't beat the best plan
+        int bound = seated + std::min(search.guestsFrom[i], freeSeats);
+        if (bound < search.best.seatedGuests || (bound == search.best.seatedGuests && unused >= search.best.unusedSeats)) {
+            return;
+        }
+        if (i == parties.size()) {
+            search.best.placements = search.current;
+            search.best.seatedGuests = seated;
+            search.best.unusedSeats = unused;
+            return;
+        }
+
+        const Party& party = parties[i];
+        for (const Option& option : options) {
+            if (option.capacity < party.size || search.used[option.first] || (option.second >= 0 && search.used[option.second])) {
+                continue;
+            }
+            search.used[option.first] = 1;
+            if (option.second >= 0) {
+                search.used[option.second] = 1;
+            }
+            search.current.push_back(placementFor(party, option));
+
+            branch(search, i + 1, seated + party.size, unused + option.capacity - party.size, freeSeats - option.capacity);
+
+            search.current.pop_back();
+            search.used[option.first] = 0;
+            if (option.second >= 0) {
+                search.used[option.second] = 0;
+            }
+        }
+
+        // Leave this party waiting
+        branch(search, i + 1, seated, unused, freeSeats);
+    }
+
+public:
+    SeatingOptimizer(const std::vector<FreeTable>& freeTables, const std::vector<Party>& waiting)
+        : freeTables(freeTables), parties(waiting) {
+        std::stable_sort(parties.begin(), parties.end(), [](const Party& a, const Party& b) { return a.size > b.size; });
+
+        for (size_t t = 0; t < freeTables.size(); ++t) {
+            options.push_back(Option{ static_cast<int>(t), -1, freeTables[t].capacity });
+            for (size_t u = 0; u < freeTables.size(); ++u) {
+                if (freeTables[u].tableNumber == freeTables[t].tableNumber + 1) {
+                    options.push_back(Option{ static_cast<int>(t), static_cast<int>(u), freeTables[t].capacity + freeTables[u].capacity });
+                }
+            }
+        }
+        std::stable_sort(options.begin(), options.end(), [](const Option& a, const Option& b) {
+            return a.capacity != b.capacity ? a.capacity < b.capacity : a.second < b.second;
+        });
+    }
+
+    Plan bestFit() const {
+        auto started = std::chrono::steady_clock::now();
+        Plan plan;
+        std::vector<char> used(freeTables.size(), 0);
+        for (const Party& party : parties) {
+            for (const Option& option : options) {
+                if (option.capacity >= party.size && !used[option.first] && (option.second < 0 || !used[option.second])) {
+                    used[option.first] = 1;
+                    if (option.second >= 0) {
+                        used[option.second] = 1;
+                    }
+                    plan.placements.push_back(placementFor(party, option));
+                    plan.seatedGuests += party.size;
+                    plan.unusedSeats += option.capacity - party.size;
+                    break;
+                }
+            }
+        }
+        plan.millis = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - started).count();
+        return plan;
     }
 
-    // Getters
-    std::string getReservationId() const { return reservationId; }
-    std::string getCustomerName() const { return customerName; }
-    std::string getContactNumber() const { return contactNumber; }
-    std::string getDateTime() const { return dateTime; }
-    int getPartySize() const { return partySize; }
-    int getTableNumber() const { return tableNumber; }
-    bool isConfirmed() const { return confirmed; }
+    Plan exact(double budgetMillis) const {
+        auto started = std::chrono::steady_clock::now();
+        Search search;
+        search.used.assign(freeTables.size(), 0);
+        search.guestsFrom.assign(parties.size() + 1, 0);
+        for (size_t i = parties.size(); i-- > 0;) {
+            search.guestsFrom[i] = search.guestsFrom[i + 1] + parties[i].size;
+        }
+        search.deadline = started + std::chrono::microseconds(static_cast<long long>(budgetMillis * 1000));
 
-    void setConfirmed(bool status) { confirmed = status; }
+        // Start from the greedy plan so the search only has to improve on it
+        search.best = bestFit();
+        int freeSeats = 0;
+        for (const FreeTable& table : freeTables) {
+            freeSeats += table.capacity;
+        }
+        // If it seats everyone without wasting a seat there is nothing to improve
+        if (search.best.seatedGuests < search.guestsFrom[0] || search.best.unusedSeats > 0) {
+            branch(search, 0, 0, 0, freeSeats);
+        }
 
-    void display() const {
-        std::cout << "Reservation ID: " << reservationId
-            << " | Customer: " << customerName
-            << " | Contact: " << contactNumber
-            << " | Date/Time: " << dateTime
-            << " | Party Size: " << partySize
-            << " | Table: " << tableNumber
-            << " | Status: " << (confirmed ? "Confirmed" : "Cancelled")
-            << std::endl;
+        Plan plan = search.best;
+        plan.optimal = !search.timedOut;
+        plan.nodes = search.nodes;
+        plan.millis = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - started).count();
+        return plan;
     }
+};
 
-    std::string getReservationInfo() const {
-        return customerName + " (" + dateTime + ", " + std::to_string(partySize) + " people)";
+// One bucket of the occupancy time series
+struct OccupancySample {
+    time_t start;
+    double tableSeconds;  // Sum over time of occupied tables
+    double seatSeconds;   // Sum over time of seated guests
+    int turns;            // Tables freed in this bucket
+    double turnSeconds;   // Total seated time of those turns
+    int peakTables;
+};
+
+// Occupancy samples at one resolution, kept in a fixed-size ring
+class OccupancyTier {
+private:
+    time_t resolution;
+    TwoCli::RingBuffer<OccupancySample> samples;
+
+    // Make the newest sample the bucket containing 'when', adding empty ones for any gap
+    void moveTo(time_t when) {
+        time_t bucketStart = when - when % resolution;
+        if (!samples.empty() && bucketStart < samples.newest().start + resolution) {
+            return;
+        }
+
+        time_t next = samples.empty() ? bucketStart : samples.newest().start + resolution;
+        if (bucketStart - next >= static_cast<time_t>(samples.capacity()) * resolution) {
+            next = bucketStart - static_cast<time_t>(samples.capacity() - 1) * resolution;
+        }
+        int carriedPeak = samples.empty() ? 0 : currentTables;
+        for (; next <= bucketStart; next += resolution) {
+            samples.push(OccupancySample{ next, 0.0, 0.0, 0, 0.0, carriedPeak });
+        }
+    }
+
+public:
+    int currentTables; // Occupied tables right now, carried into new buckets as their starting peak
+
+    OccupancyTier(time_t resolution, size_t capacity)
+        : resolution(resolution), samples(capacity), currentTables(0) {
+    }
+
+    // Spread 'tables' occupied tables and 'seats' guests over [from, to)
+    void accumulate(time_t from, time_t to, int tables, int seats) {
+        if (to - from > static_cast<time_t>(samples.capacity()) * resolution) {
+            from = to - static_cast<time_t>(samples.capacity()) * resolution;
+        }
+        while (from < to) {
+            moveTo(from);
+            OccupancySample& sample = samples.newest();
+            time_t end = std::min(to, sample.start + resolution);
+            sample.tableSeconds += static_cast<double>(tables) * (end - from);
+            sample.seatSeconds += static_cast<double>(seats) * (end - from);
+            from = end;
+        }
+    }
+
+    void recordTurn(time_t when, time_t seatedSeconds) {
+        moveTo(when);
+        samples.newest().turns++;
+        samples.newest().turnSeconds += static_cast<double>(seatedSeconds);
+    }
+
+    void notePeak(time_t when, int tables) {
+        moveTo(when);
+        samples.newest().peakTables = std::max(samples.newest().peakTables, tables);
+    }
+
+    time_t getResolution() const { return resolution; }
+    const TwoCli::RingBuffer<OccupancySample>& getSamples() const { return samples; }
+};
+
+// Table occupancy over time. Seat and free events from assignTable and
+// generateBill go into a fixed ring of raw events and are integrated into
+// per-minute (last 24 hours) and per-hour (last 30 days) tiers, so memory
+// stays the same however long the system runs.
+class OccupancyHistory {
+public:
+    struct Event {
+        time_t when;
+        int tableNumber;
+        int partySize;
+        bool seated;
+    };
+
+    struct Summary {
+        double seatUtilization;   // Share of all seats in use, time-weighted
+        double tableUtilization;  // Share of tables in use, time-weighted
+        int turns;
+        double averageTurnMinutes;
+        time_t peakHourStart;     // 0 if there was no activity
+        double peakHourTables;    // Average occupied tables during the peak hour
+    };
+
+private:
+    TwoCli::RingBuffer<Event> events;
+    OccupancyTier minutes;
+    OccupancyTier hours;
+    std::unordered_map<int, std::pair<time_t, int>> seatedParties; // table -> (seated at, party size)
+    int totalTables;
+    int totalSeats;
+    int seatedGuests;
+    time_t lastChange;
+
+    // Bring both tiers up to 'now' with the state that held since the last change
+    void integrateTo(time_t now) {
+        if (now > lastChange) {
+            int tables = static_cast<int>(seatedParties.size());
+            minutes.accumulate(lastChange, now, tables, seatedGuests);
+            hours.accumulate(lastChange, now, tables, seatedGuests);
+            lastChange = now;
+        }
+    }
+
+public:
+    OccupancyHistory(int totalTables, int totalSeats)
+        : events(4096), minutes(60, 24 * 60), hours(3600, 24 * 30),
+        totalTables(totalTables), totalSeats(totalSeats), seatedGuests(0), lastChange(time(0)) {
+    }
+
+    void tableSeated(int tableNumber, int partySize, time_t now) {
+        integrateTo(now);
+        seatedParties[tableNumber] = std::make_pair(now, partySize);
+        seatedGuests += partySize;
+        events.push(Event{ now, tableNumber, partySize, true });
+
+        int tables = static_cast<int>(seatedParties.size());
+        minutes.currentTables = hours.currentTables = tables;
+        minutes.notePeak(now, tables);
+        hours.notePeak(now, tables);
+    }
+
+    void tableFreed(int tableNumber, time_t now) {
+        auto it = seatedParties.find(tableNumber);
+        if (it == seatedParties.end()) {
+            return;
+        }
+        integrateTo(now);
+        time_t seatedFor = now - it->second.first;
+        seatedGuests -= it->second.second;
+        events.push(Event{ now, tableNumber, it->second.second, false });
+        seatedParties.erase(it);
+
+        minutes.recordTurn(now, seatedFor);
+        hours.recordTurn(now, seatedFor);
+        minutes.currentTables = hours.currentTables = static_cast<int>(seatedParties.size());
+    }
+
+    // Utilization, turn time and peak hour over the last 'seconds', from the
+    // finest tier that still covers the period
+    Summary summarize(time_t seconds, time_t now) {
+        integrateTo(now);
+        const OccupancyTier& tier = (seconds <= 24 * 3600) ? minutes : hours;
+        const TwoCli::RingBuffer<OccupancySample>& samples = tier.getSamples();
+        time_t since = now - seconds;
+
+        double tableSeconds = 0.0, seatSeconds = 0.0, turnSeconds = 0.0;
+        int turns = 0;
+        std::map<time_t, double> tableSecondsByHour;
+        for (size_t i = 0; i < samples.size(); ++i) {
+            const OccupancySample& sample = samples.at(i);
+            if (sample.start + tier.getResolution() <= since) {
+                continue;
+            }
+            tableSeconds += sample.tableSeconds;
+            seatSeconds += sample.seatSeconds;
+            turns += sample.turns;
+            turnSeconds += sample.turnSeconds;
+            tableSecondsByHour[sample.start - sample.start % 3600] += sample.tableSeconds;
+        }
+
+        Summary summary = { 0.0, 0.0, turns, 0.0, 0, 0.0 };
+        if (seconds > 0 && totalSeats > 0 && totalTables > 0) {
+            summary.seatUtilization = seatSeconds / (static_cast<double>(totalSeats) * seconds);
+            summary.tableUtilization = tableSeconds / (static_cast<double>(totalTables) * seconds);
+        }
+        if (turns > 0) {
+            summary.averageTurnMinutes = turnSeconds / turns / 60.0;
+        }
+        for (const auto& hour : tableSecondsByHour) {
+            if (hour.second / 3600.0 > summary.peakHourTables) {
+                summary.peakHourStart = hour.first;
+                summary.peakHourTables = hour.second / 3600.0;
+            }
+        }
+        return summary;
+    }
+
+    // The most recent raw events, newest last
+    std::vector<Event> recentEvents(size_t count) const {
+        std::vector<Event> recent;
+        size_t first = events.size() > count ? events.size() - count : 0;
+        for (size_t i = first; i < events.size(); ++i) {
+            recent.push_back(events.at(i));
+        }
+        return recent;
+    }
+};
+
+// Something the timer service should bring back to the UI loop
+struct TimerEvent {
+    enum Kind {
+        ReservationNoShow,  // Grace period after a booking's start has passed
+        OrderAging          // Order has sat in one status too long
+    };
+
+    Kind kind;
+    ReservationId reservationId;
+    OrderId orderId;
+    OrderStatus agedStatus; // The status an aging order was in when its timer was set
+};
+
+// Something that happened on the floor or in the kitchen. Published on the
+// system's event bus; flat and fixed-size so batches never allocate.
+struct DomainEvent {
+    enum Kind {
+        OrderPlaced,          // cents: order subtotal
+        StatusChanged,        // status: the new status (Served has its own event)
+        OrderServed,
+        TableSeated,          // partySize: guests at this table
+        TableFreed,           // cents: amount billed, 0 for a joined table
+        ReservationMade,      // partySize: party booked; dueAt: when it starts
+        ReservationCancelled,
+        ReservationSeated     // Guest checked in for their booking
+    };
+
+    Kind kind;
+    time_t at;
+    int tableNumber;
+    OrderId orderId;
+    ReservationId reservationId;
+    int partySize;
+    OrderStatus status;
+    long long cents;
+    time_t dueAt;
+};
+
+const char* domainEventKindToString(DomainEvent::Kind kind) {
+    switch (kind) {
+    case DomainEvent::OrderPlaced: return "OrderPlaced";
+    case DomainEvent::StatusChanged: return "StatusChanged";
+    case DomainEvent::OrderServed: return "OrderServed";
+    case DomainEvent::TableSeated: return "TableSeated";
+    case DomainEvent::TableFreed: return "TableFreed";
+    case DomainEvent::ReservationMade: return "ReservationMade";
+    case DomainEvent::ReservationCancelled: return "ReservationCancelled";
+    case DomainEvent::ReservationSeated: return "ReservationSeated";
+    default: return "Unknown";
+    }
+}
+
+// Append-only log of every domain event, one line each:
+// time|kind|table|order|reservation|guests|status|cents
+class AuditLog {
+private:
+    std::ofstream file;
+
+public:
+    explicit AuditLog(const std::string& filename) : file(filename, std::ios::app) {}
+
+    // Formats into a stack buffer, so recording a batch does not allocate
+    void record(const DomainEvent* events, size_t count) {
+        char when[20], orderText[32], reservationText[32], line[192];
+        for (size_t i = 0; i < count; ++i) {
+            const DomainEvent& event = events[i];
+            struct tm local = toLocalTime(event.at);
+            std::strftime(when, sizeof(when), "%Y-%m-%d %H:%M:%S", &local);
+            orderText[0] = reservationText[0] = '\0';
+            if (event.orderId.isValid()) {
+                event.orderId.formatTo(orderText, sizeof(orderText));
+            }
+            if (event.reservationId.isValid()) {
+                event.reservationId.formatTo(reservationText, sizeof(reservationText));
+            }
+            int length = std::snprintf(line, sizeof(line), "%s|%s|%d|%s|%s|%d|%d|%lld\n", when,
+                domainEventKindToString(event.kind), event.tableNumber, orderText, reservationText,
+                event.partySize, static_cast<int>(event.status), event.cents);
+            file.write(line, std::min<int>(length, static_cast<int>(sizeof(line)) - 1));
+        }
+        file.flush();
+    }
+};
+
+// One kitchen display update in the shared-memory ring. Plain bytes only:
+// display processes copy it as is, with no parsing.
+struct SharedKitchenTicket {
+    unsigned long long orderId;  // OrderId raw value
+    long long publishedAtMicros; // Wall clock, so the display can show how fresh it is
+    long long placedAt;
+    int tableNumber;
+    int status;                  // OrderStatus
+    int itemCount;
+    char items[116];             // "Burger x2, Fries x1", cut short if it does not fit
+};
+
+const char* const KITCHEN_RING_NAME = "eats_kitchen_tickets";
+const size_t KITCHEN_RING_CAPACITY = 1024;
+typedef TwoCli::SharedRing<SharedKitchenTicket, KITCHEN_RING_CAPACITY> KitchenTicketRing;
+
+long long wallClockMicros() {
+    return std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::system_clock::now().time_since_epoch()).count();
+}
+
+// Kitchen stations an order's items are split across
+enum class KitchenStation {
+    Cold,
+    Wok,
+    Dessert,
+    Bar
+};
+
+const int KITCHEN_STATION_COUNT = 4;
+
+std::string kitchenStationToString(KitchenStation station) {
+    switch (station) {
+    case KitchenStation::Cold: return "Cold";
+    case KitchenStation::Wok: return "Wok";
+    case KitchenStation::Dessert: return "Dessert";
+    case KitchenStation::Bar: return "Bar";
+    default: return "Unknown";
+    }
+}
+
+// Menu categories map onto stations; anything unrecognised is cooked on the wok
+KitchenStation stationForCategory(const std::string& category) {
+    if (category == "Appetizer") return KitchenStation::Cold;
+    if (category == "Dessert") return KitchenStation::Dessert;
+    if (category == "Beverage") return KitchenStation::Bar;
+    return KitchenStation::Wok;
+}
+
+// Typical minutes from firing a ticket to it being ready
+int stationPrepMinutes(KitchenStation station) {
+    switch (station) {
+    case KitchenStation::Cold: return 5;
+    case KitchenStation::Wok: return 12;
+    case KitchenStation::Dessert: return 6;
+    case KitchenStation::Bar: return 3;
+    default: return 10;
+    }
+}
+
+// One order line as the kitchen sees it
+struct KitchenTicket {
+    OrderId orderId;
+    int tableNumber;
+    std::string itemName;
+    int quantity;
+    std::string specialInstructions;
+    KitchenStation station;
+    time_t placedAt;
+    time_t fireAt;    // When to start so it lands with the rest of the table
+    time_t targetAt;  // When the table's items should all be ready
+};
+
+// Splits orders into per-station tickets and keeps one priority queue per
+// station, earliest fire time first and oldest ticket first among equals.
+// Fire times are staggered back from a shared target by each station's prep
+// time, so a table's quick items don't sit waiting for its slow ones.
+class KitchenRouter {
+public:
+    struct StationStats {
+        int depth;               // Tickets waiting
+        int dueNow;              // Of those, past their fire time
+        long long oldestWaitSeconds;
+        double averageWaitMinutes; // Placement to completion, this shift
+        int completed;
+    };
+
+private:
+    struct OpenOrder {
+        int remaining;
+        int perStation[KITCHEN_STATION_COUNT];
+        int tableNumber;
+    };
+
+    // Max-heap comparator, so the earliest fire time sits on top
+    struct FiresLater {
+        bool operator()(const KitchenTicket& a, const KitchenTicket& b) const {
+            return a.fireAt != b.fireAt ? a.fireAt > b.fireAt : a.placedAt > b.placedAt;
+        }
+    };
+
+    std::vector<KitchenTicket> queues[KITCHEN_STATION_COUNT]; // Binary heaps
+    int depth[KITCHEN_STATION_COUNT] = {};
+    long long completedWaitSeconds[KITCHEN_STATION_COUNT] = {};
+    int completedCount[KITCHEN_STATION_COUNT] = {};
+    std::unordered_map<OrderId, OpenOrder> openOrders;
+    std::unordered_map<int, time_t> tableTargets; // Target for each table with tickets in flight
+
+    // Drop tickets from the top of a queue whose order was withdrawn
+    void skipWithdrawn(std::vector<KitchenTicket>& queue) {
+        while (!queue.empty() && openOrders.find(queue.front().orderId) == openOrders.end()) {
+            std::pop_heap(queue.begin(), queue.end(), FiresLater());
+            queue.pop_back();
+        }
+    }
+
+public:
+    // Route every line of a new order; returns how many tickets were created
+    int route(const Order& order, const Menu& menu, time_t now) {
+        const auto& items = order.getItems();
+        if (items.empty()) {
+            return 0;
+        }
+
+        std::vector<KitchenStation> stations;
+        int longestPrep = 0;
+        for (const auto& item : items) {
+            const MenuItem* menuItem = menu.findItem(item.getItemId());
+            KitchenStation station = stationForCategory(menuItem != nullptr ? menuItem->getCategory() : "");
+            stations.push_back(station);
+            longestPrep = std::max(longestPrep, stationPrepMinutes(station));
+        }
+
+        // Land with anything the table already has on the go
+        time_t target = now + longestPrep * 60;
+        auto tableTarget = tableTargets.find(order.getTableNumber());
+        if (tableTarget != tableTargets.end()) {
+            target = std::max(target, tableTarget->second);
+        }
+        tableTargets[order.getTableNumber()] = target;
+
+        OpenOrder& open = openOrders[order.getOrderId()];
+        open.tableNumber = order.getTableNumber();
+        for (size_t i = 0; i < items.size(); ++i) {
+            KitchenStation station = stations[i];
+            KitchenTicket ticket = { order.getOrderId(), order.getTableNumber(), items[i].getItemName(), items[i].getQuantity(),
+                items[i].getSpecialInstructions(), station, now, target - stationPrepMinutes(station) * 60, target };
+
+            std::vector<KitchenTicket>& queue = queues[static_cast<int>(station)];
+            queue.push_back(ticket);
+            std::push_heap(queue.begin(), queue.end(), FiresLater());
+            depth[static_cast<int>(station)]++;
+            open.perStation[static_cast<int>(station)]++;
+            open.remaining++;
+        }
+        return static_cast<int>(items.size());
+    }
+
+    // Next ticket a station should work on, or nullptr
+    const KitchenTicket* next(KitchenStation station) {
+        std::vector<KitchenTicket>& queue = queues[static_cast<int>(station)];
+        skipWithdrawn(queue);
+        return queue.empty() ? nullptr : &queue.front();
+    }
+
+    // Complete the station's next ticket. Returns false if there was none;
+    // orderDone is set when that was the order's last outstanding ticket.
+    bool complete(KitchenStation station, time_t now, KitchenTicket& done, bool& orderDone) {
+        int index = static_cast<int>(station);
+        std::vector<KitchenTicket>& queue = queues[index];
+        skipWithdrawn(queue);
+        if (queue.empty()) {
+            return false;
+        }
+
+        std::pop_heap(queue.begin(), queue.end(), FiresLater());
+        done = queue.back();
+        queue.pop_back();
+        depth[index]--;
+        completedWaitSeconds[index] += static_cast<long long>(now - done.placedAt);
+        completedCount[index]++;
+
+        auto open = openOrders.find(done.orderId);
+        open->second.perStation[index]--;
+        orderDone = (--open->second.remaining == 0);
+        if (orderDone) {
+            withdraw(done.orderId);
+        }
+        return true;
+    }
+
+    // Stop tracking an order, e.g. when it is marked ready or cancelled by hand.
+    // Its remaining tickets are dropped lazily as they reach the top of their queue.
+    void withdraw(OrderId orderId) {
+        auto open = openOrders.find(orderId);
+        if (open == openOrders.end()) {
+            return;
+        }
+        for (int station = 0; station < KITCHEN_STATION_COUNT; ++station) {
+            depth[station] -= open->second.perStation[station];
+        }
+        int tableNumber = open->second.tableNumber;
+        openOrders.erase(open);
+
+        bool tableBusy = false;
+        for (const auto& other : openOrders) {
+            if (other.second.tableNumber == tableNumber) {
+                tableBusy = true;
+                break;
+            }
+        }
+        if (!tableBusy) {
+            tableTargets.erase(tableNumber);
+        }
+    }
+
+    bool isTracking(OrderId orderId) const { return openOrders.count(orderId) != 0; }
+
+    StationStats stats(KitchenStation station, time_t now) const {
+        int index = static_cast<int>(station);
+        StationStats result = { depth[index], 0, 0, 0.0, completedCount[index] };
+        for (const auto& ticket : queues[index]) {
+            if (openOrders.count(ticket.orderId) == 0) {
+                continue;
+            }
+            if (ticket.fireAt <= now) {
+                result.dueNow++;
+            }
+            result.oldestWaitSeconds = std::max(result.oldestWaitSeconds, static_cast<long long>(now - ticket.placedAt));
+        }
+        if (completedCount[index] > 0) {
+            result.averageWaitMinutes = completedWaitSeconds[index] / 60.0 / completedCount[index];
+        }
+        return result;
+    }
+
+    // Live tickets for a station in the order they will be worked
+    std::vector<KitchenTicket> upcoming(KitchenStation station) const {
+        std::vector<KitchenTicket> tickets;
+        for (const auto& ticket : queues[static_cast<int>(station)]) {
+            if (openOrders.count(ticket.orderId) != 0) {
+                tickets.push_back(ticket);
+            }
+        }
+        std::sort(tickets.begin(), tickets.end(), [](const KitchenTicket& a, const KitchenTicket& b) { return FiresLater()(b, a); });
+        return tickets;
+    }
+};
+
+// Outcome of a core operation, shared by the interactive menus and terminal sessions
+enum class OpResult {
+    Ok,
+    InvalidTable,
+    TableOccupied,
+    TableNotOccupied,
+    PartyTooLarge,
+    EmptyOrder,
+    UnknownItem,
+    ItemUnavailable,
+    OrderNotFound,
+    InvalidTransition,
+    NothingToBill,
+    NoTableAvailable,
+    ReservationNotFound
+};
+
+std::string opResultToString(OpResult result) {
+    switch (result) {
+    case OpResult::Ok: return "OK";
+    case OpResult::InvalidTable: return "Invalid table number";
+    case OpResult::TableOccupied: return "Table is already occupied";
+    case OpResult::TableNotOccupied: return "Table is not occupied";
+    case OpResult::PartyTooLarge: return "Party size exceeds table capacity";
+    case OpResult::EmptyOrder: return "Order is empty";
+    case OpResult::UnknownItem: return "Item not found";
+    case OpResult::ItemUnavailable: return "Item is currently unavailable";
+    case OpResult::OrderNotFound: return "Order not found";
+    case OpResult::InvalidTransition: return "Order is not in a state that allows this";
+    case OpResult::NothingToBill: return "No active orders found for this table";
+    case OpResult::NoTableAvailable: return "No suitable table available at that time";
+    case OpResult::ReservationNotFound: return "Reservation not found or already cancelled";
+    default: return "Unknown";
+    }
+}
+
+// One line of an order as entered at a terminal
+struct OrderLineRequest {
+    std::string itemId;
+    int quantity;
+    std::string specialInstructions;
+};
+
+// Walk-in party waiting for a table
+struct WaitingParty {
+    std::string customerName;
+    int partySize;
+    time_t since;
+};
+
+// Order lines as script text: item,quantity[,instructions] joined by ';'
+std::string formatOrderLines(const std::vector<OrderLineRequest>& lines) {
+    std::string text;
+    for (const auto& line : lines) {
+        if (!text.empty()) {
+            text += ';';
+        }
+        text += escapeField(line.itemId) + "," + std::to_string(line.quantity);
+        if (!line.specialInstructions.empty()) {
+            text += "," + escapeField(line.specialInstructions);
+        }
+    }
+    return text;
+}
+
+// Inverse of formatOrderLines; false if any line is malformed
+bool parseOrderLines(const std::string& text, std::vector<OrderLineRequest>& lines) {
+    lines.clear();
+    for (const std::string& entry : splitFields(text, ';')) {
+        std::vector<std::string> parts = splitFields(entry, ',');
+        if (parts.size() < 2 || parts.size() > 3) {
+            return false;
+        }
+        int quantity = std::atoi(parts[1].c_str());
+        if (parts[0].empty() || quantity <= 0) {
+            return false;
+        }
+        lines.push_back(OrderLineRequest{ unescapeField(parts[0]), quantity, parts.size() == 3 ? unescapeField(parts[2]) : "" });
+    }
+    return !lines.empty();
+}
+
+// Appends every successful core operation to a transaction script, so a
+// real shift can be replayed later with --script (see ScriptRunner). Several
+// sessions record at once: each operation takes a ticket under the lock that
+// orders it and records after letting go of its leaf lock, and lines reach
+// the file in ticket order, so a replay never meets an order before it was placed.
+class ScriptRecorder {
+private:
+    std::atomic<unsigned long long> issued{ 0 };
+    std::mutex fileMutex; // Leaf
+    std::ofstream file;
+    unsigned long long nextToWrite = 0;
+    std::map<unsigned long long, std::string> waiting; // Lines whose earlier tickets aren't recorded yet
+
+    void write(const std::string& line) {
+        file << line << '\n';
+        ++nextToWrite;
+    }
+
+public:
+    explicit ScriptRecorder(const std::string& filename) : file(filename, std::ios::app) {}
+
+    bool isOpen() const { return file.is_open(); }
+
+    // Every ticket taken must be recorded, or later lines are held back
+    unsigned long long nextTicket() { return issued.fetch_add(1); }
+
+    void record(unsigned long long ticket, const std::string& line) {
+        std::lock_guard<std::mutex> lock(fileMutex);
+        if (ticket != nextToWrite) {
+            waiting.emplace(ticket, line);
+            return;
+        }
+        write(line);
+        for (auto next = waiting.begin(); next != waiting.end() && next->first == nextToWrite; next = waiting.erase(next)) {
+            write(next->second);
+        }
+        file.flush(); // Keep what happened so far if the terminal goes down
+    }
+};
+
+// Rows of the manager's live dashboard, copied out under the lock that owns each source
+struct TableRow {
+    int tableNumber;
+    int capacity;
+    bool occupied;
+
+    bool operator==(const TableRow& other) const {
+        return tableNumber == other.tableNumber && capacity == other.capacity && occupied == other.occupied;
+    }
+};
+
+struct ReadyRow {
+    OrderId orderId;
+    int tableNumber;
+    int itemCount;
+    long long waitingMinutes; // Since the order was placed
+
+    bool operator==(const ReadyRow& other) const {
+        return orderId == other.orderId && tableNumber == other.tableNumber && itemCount == other.itemCount
+            && waitingMinutes == other.waitingMinutes;
+    }
+};
+
+struct ArrivalRow {
+    ReservationId reservationId;
+    time_t dueAt;
+    int tableNumber;
+    int partySize;
+    long long minutesAway; // Negative once the party is late
+
+    bool operator==(const ArrivalRow& other) const {
+        return reservationId == other.reservationId && dueAt == other.dueAt && tableNumber == other.tableNumber
+            && partySize == other.partySize && minutesAway == other.minutesAway;
     }
 };
 
@@ -544,14 +3256,86 @@ public:
 class RestaurantSystem {
 private:
     std::string restaurantName;
+    std::string dataDirectory; // Prefix for the files the system reads and writes
     Menu menu;
     std::vector<Table> tables;
-    std::vector<Reservation> reservations;
-    std::vector<Order> orders;
+    std::unique_ptr<TableAvailability> availability; // Bitsets over 'tables', kept in step by setTableOccupied/setTableReservation
+    ReservationBook reservations;
+    KitchenRouter kitchen;
+    TwoCli::MpmcQueue<OrderId> kitchenHandoff{ 1024 }; // Placed orders on their way to the stations
+    std::unique_ptr<ReservationCalendar> calendar; // Time-slotted bookings per table
+    std::vector<WaitingParty> waitlist;
+    std::map<int, int> joinedTables; // Table billed for a combined party -> the table joined to it
+    ShiftArena shiftArena; // Must outlive every order allocated from it
+    OrderArchive archive;
+    OrderRepository orders;
+    OrderLineFacts salesFacts; // Lines of every completed order, for reports
+    SalesAggregates dailySales;
+    PopularItemsTracker popularItems;
+    std::unique_ptr<OccupancyHistory> occupancyHistory; // Created once the tables are set up
     std::vector<std::shared_ptr<User>> users;
     std::shared_ptr<User> currentUser;
-    int nextOrderId;
-    int nextReservationId;
+    IdGenerator<OrderId> orderIds;
+    IdGenerator<ReservationId> reservationIds;
+
+    static constexpr double SEATING_SEARCH_BUDGET_MS = 5.0;
+
+    // Time-driven work: the timer thread posts due events to the inbox and the
+    // menu loop handles them, so all state changes stay on the UI thread.
+    // Declared last so the timer thread stops before anything it posts to goes away.
+    static const int NO_SHOW_GRACE_MINUTES = 15;
+    static const int PENDING_ALERT_MINUTES = 10;
+    static const int IN_PROGRESS_ALERT_MINUTES = 20;
+    std::unordered_map<ReservationId, TwoCli::TimerHandle> noShowTimers;
+    std::unordered_map<OrderId, TwoCli::TimerHandle> agingTimers;
+    TwoCli::ConcurrentInbox<TimerEvent> dueTimers;
+    std::unique_ptr<TwoCli::TimerService<TimerEvent>> timers;
+
+    // Locks for concurrent terminal sessions. Always taken in this order:
+    // table, then order, then the menu (shared), then at most one leaf lock.
+    // Only one table or order lock is held at a time, except a combined party's
+    // second table, which is always the higher-numbered one.
+    static const size_t ORDER_LOCK_STRIPES = 64;
+    std::unique_ptr<std::mutex[]> tableLocks; // One per table, in 'tables' order
+    std::mutex orderLocks[ORDER_LOCK_STRIPES]; // Striped by order id
+    std::shared_mutex menuMutex;
+    std::atomic<unsigned long long> menuVersion{ 1 }; // Bumped by every menu edit
+    std::mutex orderIndexMutex; // Leaf: the order repository and its indexes
+    std::mutex floorMutex;      // Leaf: availability bitsets, occupancy history, joined tables, expected arrivals
+    std::mutex analyticsMutex;  // Leaf: sales facts, daily sales, popular items
+    std::mutex kitchenMutex;    // Leaf: the kitchen router
+    std::mutex timerMapMutex;   // Leaf: no-show and aging timer handles
+
+    // Every order, table and reservation change is published here. The pool
+    // delivers each batch to the kitchen export, the kitchen monitor, the
+    // occupancy history and the audit log, in that order.
+    TwoCli::EventBus<DomainEvent> events;
+    AuditLog auditLog;
+    std::atomic<unsigned long long> kitchenBoardVersion{ 0 }; // Bumped by batches that touch open orders; see kitchenBoardChanged
+    std::mutex kitchenExportWriteMutex; // One kitchen_orders.txt write at a time
+
+    // File writes and monitor reads run on the background pool; results for
+    // the user come back through the notice inbox, printed by the menu loop
+    TwoCli::ConcurrentInbox<std::string> backgroundNotices;
+    std::unique_ptr<KitchenTicketRing> kitchenRing; // Set by enableKitchenFeed
+    std::unique_ptr<TwoCli::LineBroadcastServer> kitchenServer; // Set by enableKitchenServer
+    std::unique_ptr<ScriptRecorder> recorder; // Set by recordScript
+
+    // Bookings still to arrive, kept from reservation events under floorMutex
+    std::unordered_map<ReservationId, DomainEvent> expectedArrivals;
+
+    // The manager's dashboard while it is open; event batches wake the panels
+    // whose sources they touched
+    enum DashboardSource { KitchenSource, TablesSource, ReadySource, ArrivalsSource };
+    static const int DASHBOARD_ARRIVAL_HOURS = 3;
+    std::mutex dashboardMutex; // Leaf
+    TwoCli::Dashboard* openDashboard = nullptr;
+    // Declared last so queued tasks finish before the members they use go away
+    std::unique_ptr<TwoCli::WorkStealingPool> background;
+
+    std::mutex& orderLock(OrderId orderId) {
+        return orderLocks[std::hash<OrderId>()(orderId) % ORDER_LOCK_STRIPES];
+    }
 
 
 
@@ -559,43 +3343,194 @@ private:
 private:
     // need to add a place to save the orderrs bro 
 
+    // Runs on the pool for each event batch that touches open orders, so a
+    // burst of changes costs one write
     void saveOrdersToFile() {
+        std::lock_guard<std::mutex> writeLock(kitchenExportWriteMutex);
+
         // Save orders to a file for live monitoring
         std::vector<KitchenOrder> kitchenOrders;
+        std::lock_guard<std::mutex> lock(orderIndexMutex);
+        for (const Order* order : orders.findByStatus({ OrderStatus::Pending, OrderStatus::InProgress })) {
+            KitchenOrder ko;
+            ko.id = order->getOrderId();
+            ko.tableNumber = order->getTableNumber();
+            ko.status = orderStatusToString(order->getStatus());
+
+            // Create a summary of items
+            std::string items;
+            for (const auto& item : order->getItems()) {
+                items += item.getItemName() + " x" +
+                    std::to_string(item.getQuantity()) + ", ";
+            }
+            if (!items.empty()) {
+                items.pop_back();
+                items.pop_back();
+            }
+            ko.itemList = items;
+
+            kitchenOrders.push_back(ko);
+        }
+
+        // Use FileManager to save the kitchen orders
+        TwoCli::FileManager<KitchenOrder> orderManager(dataDirectory + "kitchen_orders.txt");
+        orderManager.writeRecords(kitchenOrders);
+    }
+
+    void publish(DomainEvent::Kind kind, int tableNumber, OrderId orderId = OrderId(), ReservationId reservationId = ReservationId(),
+        int partySize = 0, OrderStatus status = OrderStatus::Pending, long long cents = 0, time_t dueAt = 0) {
+        events.publish(DomainEvent{ kind, time(0), tableNumber, orderId, reservationId, partySize, status, cents, dueAt });
+    }
 
-        for (const auto& order : orders) {
-            if (order.getStatus() == OrderStatus::Pending ||
-                order.getStatus() == OrderStatus::InProgress) {
+    // Item details come from the order itself, read from the archive if it
+    // was closed before this batch went out
+    SharedKitchenTicket buildKitchenTicket(const DomainEvent& event) {
+        SharedKitchenTicket ticket = {};
+        ticket.orderId = event.orderId.getValue();
+        ticket.tableNumber = event.tableNumber;
+        ticket.status = static_cast<int>(event.status);
+        {
+            std::lock_guard<std::mutex> lock(orderIndexMutex);
+            orders.visit(event.orderId, [&ticket](const Order& order) {
+                ticket.placedAt = order.getPlacedAt();
+                size_t used = 0;
+                for (const auto& item : order.getItems()) {
+                    ticket.itemCount += item.getQuantity();
+                    int written = std::snprintf(ticket.items + used, sizeof(ticket.items) - used, "%s%s x%d",
+                        used > 0 ? ", " : "", item.getItemName().c_str(), item.getQuantity());
+                    if (written < 0 || used + written >= sizeof(ticket.items)) {
+                        break; // Truncated; snprintf has already terminated it
+                    }
+                    used += written;
+                }
+                });
+        }
+        ticket.publishedAtMicros = wallClockMicros();
+        return ticket;
+    }
+
+    // The same ticket as a JSON line for socket clients
+    static std::string kitchenTicketJson(const SharedKitchenTicket& ticket) {
+        return "\"order\":" + jsonQuote(OrderId(ticket.orderId).toString()) + ",\"table\":" + std::to_string(ticket.tableNumber)
+            + ",\"status\":" + jsonQuote(orderStatusToString(static_cast<OrderStatus>(ticket.status)))
+            + ",\"items\":" + jsonQuote(ticket.items) + ",\"itemCount\":" + std::to_string(ticket.itemCount)
+            + ",\"placedAt\":" + std::to_string(ticket.placedAt) + ",\"sentAtMicros\":" + std::to_string(ticket.publishedAtMicros);
+    }
+
+    void subscribeToEvents() {
+        // Kitchen export: one rewrite of kitchen_orders.txt per batch
+        events.subscribe([this](const DomainEvent* batch, size_t count) {
+            for (size_t i = 0; i < count; ++i) {
+                DomainEvent::Kind kind = batch[i].kind;
+                if (kind == DomainEvent::OrderPlaced || kind == DomainEvent::StatusChanged || kind == DomainEvent::OrderServed) {
+                    saveOrdersToFile();
+                    kitchenBoardVersion.fetch_add(1); // Kitchen monitor: redraw once the file is written
+                    return;
+                }
+            }
+            });
+
+        // Occupancy history: table turns and utilisation; expected arrivals
+        events.subscribe([this](const DomainEvent* batch, size_t count) {
+            std::lock_guard<std::mutex> lock(floorMutex);
+            for (size_t i = 0; i < count; ++i) {
+                const DomainEvent& event = batch[i];
+                if (event.kind == DomainEvent::TableSeated) {
+                    occupancyHistory->tableSeated(event.tableNumber, event.partySize, event.at);
+                }
+                else if (event.kind == DomainEvent::TableFreed) {
+                    occupancyHistory->tableFreed(event.tableNumber, event.at);
+                }
+                else if (event.kind == DomainEvent::ReservationMade) {
+                    expectedArrivals[event.reservationId] = event;
+                }
+                else if (event.kind == DomainEvent::ReservationCancelled || event.kind == DomainEvent::ReservationSeated) {
+                    expectedArrivals.erase(event.reservationId);
+                }
+            }
+            });
 
-                KitchenOrder ko;
-                ko.id = std::stoi(order.getOrderId().substr(1));
-                ko.tableNumber = order.getTableNumber();
-                ko.status = orderStatusToString(order.getStatus());
+        events.subscribe([this](const DomainEvent* batch, size_t count) { auditLog.record(batch, count); });
 
-                // Create a summary of items
-                std::string items;
-                for (const auto& item : order.getItems()) {
-                    items += item.getMenuItem()->getName() + " x" +
-                        std::to_string(item.getQuantity()) + ", ";
-                }
-                if (!items.empty()) {
-                    items.pop_back();
-                    items.pop_back();
+        // Kitchen displays in other processes, through shared memory and/or the socket server
+        events.subscribe([this](const DomainEvent* batch, size_t count) {
+            if (kitchenRing == nullptr && kitchenServer == nullptr) {
+                return;
+            }
+            for (size_t i = 0; i < count; ++i) {
+                const DomainEvent& event = batch[i];
+                if (event.kind == DomainEvent::OrderPlaced || event.kind == DomainEvent::StatusChanged
+                    || event.kind == DomainEvent::OrderServed) {
+                    SharedKitchenTicket ticket = buildKitchenTicket(event);
+                    if (kitchenRing != nullptr) {
+                        kitchenRing->publish(ticket);
+                    }
+                    if (kitchenServer != nullptr) {
+                        kitchenServer->broadcast(kitchenTicketJson(ticket));
+                    }
                 }
-                ko.itemList = items;
+            }
+            });
 
-                kitchenOrders.push_back(ko);
+        // Manager dashboard, while open
+        events.subscribe([this](const DomainEvent* batch, size_t count) {
+            std::lock_guard<std::mutex> lock(dashboardMutex);
+            if (openDashboard == nullptr) {
+                return;
             }
-        }
+            for (size_t i = 0; i < count; ++i) {
+                switch (batch[i].kind) {
+                case DomainEvent::OrderPlaced:
+                    openDashboard->notify(KitchenSource);
+                    break;
+                case DomainEvent::StatusChanged:
+                case DomainEvent::OrderServed:
+                    openDashboard->notify(KitchenSource);
+                    openDashboard->notify(ReadySource);
+                    break;
+                case DomainEvent::TableSeated:
+                case DomainEvent::TableFreed:
+                    openDashboard->notify(TablesSource);
+                    break;
+                default:
+                    openDashboard->notify(ArrivalsSource);
+                }
+            }
+            });
 
-        // Use FileManager to save the kitchen orders
-        TwoCli::FileManager<KitchenOrder> orderManager("kitchen_orders.txt");
-        orderManager.writeRecords(kitchenOrders);
+        events.onFlushNeeded([this]() {
+            background->post([this]() { events.flush(); }, TwoCli::TaskPriority::High);
+            });
     }
 
 public:
-    RestaurantSystem(const std::string& name)
-        : restaurantName(name), nextOrderId(1), nextReservationId(1) {
+    RestaurantSystem(const std::string& name, unsigned terminalId = 0, bool useShiftArena = false,
+        const std::string& dataDirectory = "")
+        : restaurantName(name), dataDirectory(dataDirectory), shiftArena(useShiftArena),
+        archive(dataDirectory + "order_archive.txt"), orders(archive),
+        dailySales(dataDirectory + "sales_aggregates.txt"),
+        orderIds(terminalId), reservationIds(terminalId), auditLog(dataDirectory + "audit_log.txt"),
+        background(new TwoCli::WorkStealingPool()) {
+        // Continue numbering after orders archived by earlier runs
+        orderIds.skipPast(archive.getHighestSequence(terminalId));
+
+        // Load completed orders from earlier runs into the report store. The daily
+        // totals are persisted separately and only rebuilt if that file is missing.
+        bool rebuildDailySales = dailySales.empty();
+        time_t startupTime = time(0);
+        archive.forEach([this, rebuildDailySales, startupTime](const Order& order) {
+            if (order.getStatus() == OrderStatus::Completed) {
+                salesFacts.addOrder(order);
+                popularItems.recordOrder(order, startupTime);
+                if (rebuildDailySales) {
+                    dailySales.recordCompletion(order, false);
+                }
+            }
+            });
+        if (rebuildDailySales && !dailySales.empty()) {
+            dailySales.saveAll();
+        }
+
         // Initialize tables
         for (int i = 1; i <= 10; ++i) {
             if (i <= 4) {
@@ -609,6 +3544,17 @@ public:
             }
         }
 
+        int totalSeats = 0;
+        for (const auto& table : tables) {
+            totalSeats += table.getCapacity();
+        }
+        occupancyHistory.reset(new OccupancyHistory(static_cast<int>(tables.size()), totalSeats));
+        availability.reset(new TableAvailability(tables));
+        calendar.reset(new ReservationCalendar(tables));
+        timers.reset(new TwoCli::TimerService<TimerEvent>([this](const TimerEvent& event) { dueTimers.post(event); }));
+        tableLocks.reset(new std::mutex[tables.size()]);
+        subscribeToEvents();
+
         // Initialize users
         users.push_back(std::make_shared<Host>("John", "H001"));
         users.push_back(std::make_shared<Waiter>("Emily", "W001"));
@@ -652,6 +3598,10 @@ public:
             bool logout = false;
 
             while (!logout) {
+                processDueTimers();
+                for (const std::string& notice : backgroundNotices.drain()) {
+                    std::cout << "\n" << notice << "\n";
+                }
                 currentUser->displayMenu();
                 int choice;
                 std::cout << "\nEnter your choice: ";
@@ -697,6 +3647,15 @@ public:
             cancelReservation();
             break;
         case 6:
+            findReservation();
+            break;
+        case 7:
+            addToWaitlist();
+            break;
+        case 8:
+            seatWaitlist();
+            break;
+        case 9:
             return true; // Return to login
         default:
             std::cout << "Invalid choice. Please try again.\n";
@@ -729,69 +3688,659 @@ public:
         return false;
     }
 
-    //bool handleChefMenu(int choice) {
-    //    switch (choice) {
-    //    case 1:
-    //        viewPendingOrders();
-    //        break;
-    //    case 2:
-    //        updateOrderStatus();
-    //        break;
-    //    case 3:
-    //        return true; // Return to login
-    //    default:
-    //        std::cout << "Invalid choice. Please try again.\n";
-    //    }
-    //    return false;
-    //}
+    //bool handleChefMenu(int choice) {
+    //    switch (choice) {
+    //    case 1:
+    //        viewPendingOrders();
+    //        break;
+    //    case 2:
+    //        updateOrderStatus();
+    //        break;
+    //    case 3:
+    //        return true; // Return to login
+    //    default:
+    //        std::cout << "Invalid choice. Please try again.\n";
+    //    }
+    //    return false;
+    //}
+
+    //new 
+
+    bool handleChefMenu(int choice) {
+        switch (choice) {
+        case 1:
+            viewPendingOrders();
+            break;
+        case 2:
+            updateOrderStatus();
+            break;
+        case 3:
+            viewLiveOrders();  // Call the new live monitor function
+            break;
+        case 4:
+            viewStationQueues();
+            break;
+        case 5:
+            completeStationTicket();
+            break;
+        case 6:
+            return true; // Return to login
+        default:
+            cout << "Invalid choice. Please try again.\n";
+        }
+        return false;
+    }
+
+    bool handleManagerMenu(int choice) {
+        switch (choice) {
+        case 1:
+            displayTables();
+            break;
+        case 2:
+            displayAllOrders();
+            break;
+        case 3:
+            manageMenu();
+            break;
+        case 4:
+            generateReports();
+            break;
+        case 5:
+            manageStaff();
+            break;
+        case 6:
+            endShift();
+            break;
+        case 7:
+            viewDashboard();
+            break;
+        case 8:
+            return true; // Return to login
+        default:
+            std::cout << "Invalid choice. Please try again.\n";
+        }
+        return false;
+    }
+
+    // Status changes go through here so each order's aging alert follows its
+    // status. False if the order is gone or the lifecycle refuses the change.
+    // Callers hold orderLock(orderId), which is what makes each change happen
+    // once: a second serve or bill sees the status the first one left.
+    bool setOrderStatus(OrderId orderId, OrderStatus status, std::optional<Order>* changed = nullptr) {
+        int tableNumber;
+        {
+            std::lock_guard<std::mutex> lock(orderIndexMutex);
+            const Order* order = orders.find(orderId);
+            if (order == nullptr) {
+                return false;
+            }
+            tableNumber = order->getTableNumber(); // Read first: a closing order leaves the repository
+            if (!orders.updateStatus(orderId, status, changed)) {
+                return false;
+            }
+        }
+        if (status == OrderStatus::Served) {
+            publish(DomainEvent::OrderServed, tableNumber, orderId, ReservationId(), 0, status);
+        }
+        else {
+            publish(DomainEvent::StatusChanged, tableNumber, orderId, ReservationId(), 0, status);
+        }
+        scheduleAgingAlert(orderId, status);
+        if (status != OrderStatus::Pending && status != OrderStatus::InProgress) {
+            std::lock_guard<std::mutex> lock(kitchenMutex);
+            kitchen.withdraw(orderId); // Finished or cancelled outside the station flow
+        }
+        return true;
+    }
+
+    void scheduleAgingAlert(OrderId orderId, OrderStatus status) {
+        std::lock_guard<std::mutex> lock(timerMapMutex);
+        auto existing = agingTimers.find(orderId);
+        if (existing != agingTimers.end()) {
+            timers->cancel(existing->second);
+            agingTimers.erase(existing);
+        }
+
+        int minutes = status == OrderStatus::Pending ? PENDING_ALERT_MINUTES
+            : status == OrderStatus::InProgress ? IN_PROGRESS_ALERT_MINUTES : 0;
+        if (minutes > 0) {
+            TimerEvent event = { TimerEvent::OrderAging, ReservationId(), orderId, status };
+            agingTimers[orderId] = timers->schedule(std::chrono::minutes(minutes), event);
+        }
+    }
+
+    void scheduleNoShow(const Reservation& reservation) {
+        std::lock_guard<std::mutex> lock(timerMapMutex);
+        time_t releaseAt = reservation.getStartTime() + NO_SHOW_GRACE_MINUTES * 60;
+        long long delay = std::max<long long>(0, static_cast<long long>(releaseAt - time(0)));
+        TimerEvent event = { TimerEvent::ReservationNoShow, reservation.getReservationId(), OrderId(), OrderStatus::Pending };
+        noShowTimers[reservation.getReservationId()] = timers->schedule(std::chrono::seconds(delay), event);
+    }
+
+    void cancelNoShow(ReservationId reservationId) {
+        std::lock_guard<std::mutex> lock(timerMapMutex);
+        auto it = noShowTimers.find(reservationId);
+        if (it != noShowTimers.end()) {
+            timers->cancel(it->second);
+            noShowTimers.erase(it);
+        }
+    }
+
+    // Record a booking at a table and slot already found to be free
+    ReservationId bookReservation(const std::string& customerName, const std::string& contactNumber, time_t start,
+        int partySize, int tableNumber) {
+        ReservationId reservationId = reservationIds.next();
+        Reservation reservation(reservationId, customerName, contactNumber, start, partySize, tableNumber);
+        reservations.add(reservation);
+
+        calendar->pruneBefore(time(0));
+        calendar->book(tableNumber, start, customerName + " (" + reservation.getDateTime() + ")");
+        scheduleNoShow(reservation);
+        refreshTableReservations();
+        publish(DomainEvent::ReservationMade, tableNumber, OrderId(), reservationId, partySize, OrderStatus::Pending, 0, start);
+        if (recorder != nullptr) {
+            recorder->record(recorder->nextTicket(), "reserve|" + reservationId.toString() + "|" + escapeField(customerName) + "|"
+                + escapeField(contactNumber) + "|" + reservation.getDateTime() + "|" + std::to_string(partySize));
+        }
+        return reservationId;
+    }
+
+    // Act on timers that came due since the last menu; events are re-checked
+    // against current state because they may have been posted just before a cancel
+    void processDueTimers() {
+        for (const TimerEvent& event : dueTimers.drain()) {
+            if (event.kind == TimerEvent::ReservationNoShow) {
+                {
+                    std::lock_guard<std::mutex> lock(timerMapMutex);
+                    noShowTimers.erase(event.reservationId);
+                }
+                Reservation* reservation = reservations.find(event.reservationId);
+                if (reservation == nullptr || !reservation->isConfirmed()) {
+                    continue;
+                }
+                reservation->setStatus(ReservationStatus::NoShow);
+                calendar->release(reservation->getTableNumber(), reservation->getStartTime());
+                refreshTableReservations();
+                std::cout << "\n*** ALERT: " << reservation->getCustomerName() << " (reservation " << event.reservationId
+                    << ") did not arrive within " << NO_SHOW_GRACE_MINUTES << " minutes. Table "
+                    << reservation->getTableNumber() << " has been released. ***\n";
+            }
+            else {
+                {
+                    std::lock_guard<std::mutex> lock(timerMapMutex);
+                    agingTimers.erase(event.orderId);
+                }
+                const Order* order = orders.find(event.orderId);
+                if (order == nullptr || order->getStatus() != event.agedStatus) {
+                    continue;
+                }
+                int minutes = event.agedStatus == OrderStatus::Pending ? PENDING_ALERT_MINUTES : IN_PROGRESS_ALERT_MINUTES;
+                std::cout << "\n*** ALERT: Order " << event.orderId << " for table " << order->getTableNumber()
+                    << " has been " << orderStatusToString(event.agedStatus) << " for over " << minutes << " minutes. ***\n";
+            }
+        }
+    }
+
+public:
+    // Core operations. These take no console input, lock only the table or
+    // order they touch, and are what both the interactive menus and
+    // TerminalSession use, so they can be called from several threads at once.
+
+    OpResult seatParty(int tableNumber, int partySize) {
+        int slot = availability->slotOf(tableNumber);
+        if (slot < 0) {
+            return OpResult::InvalidTable;
+        }
+        std::lock_guard<std::mutex> tableLock(tableLocks[slot]);
+        Table& table = tables[slot];
+        if (table.isOccupied()) {
+            return OpResult::TableOccupied;
+        }
+        if (partySize > table.getCapacity()) {
+            return OpResult::PartyTooLarge;
+        }
+
+        unsigned long long ticket = 0;
+        {
+            std::lock_guard<std::mutex> lock(floorMutex);
+            setTableOccupied(table, true);
+            publish(DomainEvent::TableSeated, tableNumber, OrderId(), ReservationId(), partySize);
+            if (recorder != nullptr) {
+                ticket = recorder->nextTicket();
+            }
+        }
+        if (recorder != nullptr) {
+            recorder->record(ticket, "seat|" + std::to_string(tableNumber) + "|" + std::to_string(partySize));
+        }
+        return OpResult::Ok;
+    }
+
+    // Seat one party across two adjacent tables, billed on the first. Same
+    // locking as seatParty; the joined table is always the higher-numbered.
+    OpResult seatJoinedParty(int firstTable, int secondTable, int partySize) {
+        int firstSlot = availability->slotOf(firstTable);
+        int secondSlot = availability->slotOf(secondTable);
+        if (firstSlot < 0 || secondSlot < 0 || secondTable != firstTable + 1) {
+            return OpResult::InvalidTable;
+        }
+        std::lock_guard<std::mutex> firstLock(tableLocks[firstSlot]);
+        std::lock_guard<std::mutex> secondLock(tableLocks[secondSlot]);
+        Table& first = tables[firstSlot];
+        Table& second = tables[secondSlot];
+        if (first.isOccupied() || second.isOccupied()) {
+            return OpResult::TableOccupied;
+        }
+        if (partySize > first.getCapacity() + second.getCapacity()) {
+            return OpResult::PartyTooLarge;
+        }
+
+        int atFirst = std::min(partySize, first.getCapacity());
+        unsigned long long ticket = 0;
+        {
+            std::lock_guard<std::mutex> lock(floorMutex);
+            setTableOccupied(first, true);
+            publish(DomainEvent::TableSeated, firstTable, OrderId(), ReservationId(), atFirst);
+            setTableOccupied(second, true);
+            publish(DomainEvent::TableSeated, secondTable, OrderId(), ReservationId(), partySize - atFirst);
+            joinedTables[firstTable] = secondTable;
+            if (recorder != nullptr) {
+                ticket = recorder->nextTicket();
+            }
+        }
+        if (recorder != nullptr) {
+            recorder->record(ticket, "join|" + std::to_string(firstTable) + "|" + std::to_string(secondTable) + "|"
+                + std::to_string(partySize));
+        }
+        return OpResult::Ok;
+    }
+
+    // Validates every line against the current menu version before taking an id
+    OpResult placeOrder(int tableNumber, const std::string& waiterId, const std::vector<OrderLineRequest>& lines,
+        OrderId* placedId = nullptr, long long* subtotalCents = nullptr) {
+        int slot = availability->slotOf(tableNumber);
+        if (slot < 0) {
+            return OpResult::InvalidTable;
+        }
+        if (lines.empty()) {
+            return OpResult::EmptyOrder;
+        }
+        std::lock_guard<std::mutex> tableLock(tableLocks[slot]);
+        if (!tables[slot].isOccupied()) {
+            return OpResult::TableNotOccupied;
+        }
+
+        OrderId orderId;
+        Order* placed = nullptr;
+        unsigned long long ticket = 0;
+        {
+            std::shared_lock<std::shared_mutex> menuLock(menuMutex);
+            for (const auto& line : lines) {
+                const MenuItem* menuItem = menu.findItem(line.itemId);
+                if (menuItem == nullptr) {
+                    return OpResult::UnknownItem;
+                }
+                if (!menuItem->isAvailable()) {
+                    return OpResult::ItemUnavailable;
+                }
+            }
+
+            orderId = orderIds.next();
+            Order order(orderId, tableNumber, waiterId, shiftArena.resource());
+            for (const auto& line : lines) {
+                order.addItem(menu.findItem(line.itemId), line.quantity, line.specialInstructions);
+            }
+
+            std::lock_guard<std::mutex> lock(orderIndexMutex);
+            placed = &orders.add(std::move(order));
+            if (recorder != nullptr) {
+                ticket = recorder->nextTicket(); // Before anyone can find the order and start it
+            }
+        }
+
+        // The table lock keeps the order from being billed and archived under us
+        if (subtotalCents != nullptr) {
+            *subtotalCents = placed->getSubtotalCents();
+        }
+        if (placedId != nullptr) {
+            *placedId = orderId;
+        }
+        scheduleAgingAlert(orderId, OrderStatus::Pending);
+        publish(DomainEvent::OrderPlaced, tableNumber, orderId, ReservationId(), 0, OrderStatus::Pending, placed->getSubtotalCents());
+        handOffToKitchen(*placed);
+        if (recorder != nullptr) {
+            recorder->record(ticket, "order|" + orderId.toString() + "|" + std::to_string(tableNumber) + "|" + escapeField(waiterId)
+                + "|" + formatOrderLines(lines));
+        }
+        return OpResult::Ok;
+    }
+
+    // Kitchen progress: Pending or In Progress to In Progress or Ready
+    OpResult advanceOrder(OrderId orderId, OrderStatus newStatus) {
+        if (newStatus != OrderStatus::InProgress && newStatus != OrderStatus::Ready) {
+            return OpResult::InvalidTransition;
+        }
+        std::lock_guard<std::mutex> lock(orderLock(orderId));
+        if (findOpenOrder(orderId) == nullptr) {
+            return OpResult::OrderNotFound;
+        }
+        if (!setOrderStatus(orderId, newStatus)) {
+            return OpResult::InvalidTransition;
+        }
+        if (recorder != nullptr) {
+            recorder->record(recorder->nextTicket(), (newStatus == OrderStatus::InProgress ? "start|" : "ready|") + orderId.toString());
+        }
+        return OpResult::Ok;
+    }
+
+    // Only a Ready order can be served, so a second serve is refused
+    OpResult markServed(OrderId orderId) {
+        std::lock_guard<std::mutex> lock(orderLock(orderId));
+        if (findOpenOrder(orderId) == nullptr) {
+            return OpResult::OrderNotFound;
+        }
+        if (!setOrderStatus(orderId, OrderStatus::Served)) {
+            return OpResult::InvalidTransition;
+        }
+        if (recorder != nullptr) {
+            recorder->record(recorder->nextTicket(), "serve|" + orderId.toString());
+        }
+        return OpResult::Ok;
+    }
+
+    // Bill every Ready or Served order on the table, record the sales and free
+    // the table (and any table joined to it). An order counts only once its
+    // change to Completed succeeds under the order's lock, so it can never be
+    // billed twice; onBilled sees each order as it was completed.
+    OpResult settleTable(int tableNumber, const std::function<void(const Order&)>& onBilled = nullptr,
+        long long* billedCents = nullptr) {
+        int slot = availability->slotOf(tableNumber);
+        if (slot < 0) {
+            return OpResult::InvalidTable;
+        }
+        std::lock_guard<std::mutex> tableLock(tableLocks[slot]);
+        if (!tables[slot].isOccupied()) {
+            return OpResult::TableNotOccupied;
+        }
+
+        std::vector<OrderId> candidates;
+        {
+            std::lock_guard<std::mutex> lock(orderIndexMutex);
+            for (const Order* order : orders.findOpenByTable(tableNumber)) {
+                candidates.push_back(order->getOrderId());
+            }
+        }
+
+        long long totalCents = 0;
+        int billed = 0;
+        time_t now = time(0);
+        for (OrderId orderId : candidates) {
+            std::lock_guard<std::mutex> lock(orderLock(orderId));
+            const Order* open = findOpenOrder(orderId);
+            if (open == nullptr || (open->getStatus() != OrderStatus::Served && open->getStatus() != OrderStatus::Ready)) {
+                continue; // Still with the kitchen, or already billed
+            }
+            std::optional<Order> completed; // Handed back as it leaves the hot set
+            if (!setOrderStatus(orderId, OrderStatus::Completed, &completed)) {
+                continue;
+            }
+            const Order& order = *completed;
+            if (onBilled) {
+                onBilled(order);
+            }
+            totalCents += order.getSubtotalCents();
+            {
+                std::lock_guard<std::mutex> analyticsLock(analyticsMutex);
+                salesFacts.addOrder(order);
+                dailySales.recordCompletion(order);
+                popularItems.recordOrder(order, now);
+            }
+            billed++;
+        }
+
+        if (billed == 0) {
+            return OpResult::NothingToBill;
+        }
+        if (billedCents != nullptr) {
+            *billedCents = totalCents;
+        }
+
+        // A combined party frees the table joined to this one as well. Its lock
+        // is taken before floorMutex, like any table lock; it is always the
+        // higher-numbered table, so this is still ascending order.
+        int joinedNumber = -1;
+        {
+            std::lock_guard<std::mutex> lock(floorMutex);
+            auto joined = joinedTables.find(tableNumber);
+            if (joined != joinedTables.end()) {
+                joinedNumber = joined->second;
+            }
+        }
+        int joinedSlot = joinedNumber != -1 ? availability->slotOf(joinedNumber) : -1;
+        std::unique_lock<std::mutex> joinedLock;
+        if (joinedSlot >= 0) {
+            joinedLock = std::unique_lock<std::mutex>(tableLocks[joinedSlot]);
+        }
+        unsigned long long ticket = 0;
+        {
+            std::lock_guard<std::mutex> lock(floorMutex);
+            if (recorder != nullptr) {
+                ticket = recorder->nextTicket();
+            }
+            setTableOccupied(tables[slot], false);
+            publish(DomainEvent::TableFreed, tableNumber, OrderId(), ReservationId(), 0, OrderStatus::Completed, totalCents);
+
+            // Still joined now that both locks are held
+            auto joined = joinedTables.find(tableNumber);
+            if (joinedSlot >= 0 && joined != joinedTables.end() && joined->second == joinedNumber) {
+                setTableOccupied(tables[joinedSlot], false);
+                publish(DomainEvent::TableFreed, joinedNumber);
+                joinedTables.erase(joined);
+            }
+
+            // Billing the joined table itself ends the join, so settling the
+            // first table later can't free it under a new party
+            auto joinedTo = joinedTables.find(tableNumber - 1);
+            if (joinedTo != joinedTables.end() && joinedTo->second == tableNumber) {
+                joinedTables.erase(joinedTo);
+            }
+        }
+        if (recorder != nullptr) {
+            recorder->record(ticket, "settle|" + std::to_string(tableNumber));
+        }
+        return OpResult::Ok;
+    }
+
+    // Menu changes take the menu lock exclusively and publish a new version
+    template<typename Fn>
+    void editMenu(Fn edit) {
+        std::unique_lock<std::shared_mutex> lock(menuMutex);
+        edit();
+        menuVersion.fetch_add(1);
+    }
+
+    bool setMenuItemPrice(const std::string& itemId, double newPrice) {
+        bool found = false;
+        unsigned long long ticket = 0;
+        editMenu([&]() {
+            MenuItem* item = menu.findItem(itemId);
+            if (item != nullptr) {
+                item->setPrice(newPrice);
+                found = true;
+                if (recorder != nullptr) {
+                    ticket = recorder->nextTicket();
+                }
+            }
+            });
+        if (found && recorder != nullptr) {
+            std::ostringstream line;
+            line << "price|" << escapeField(itemId) << "|" << std::fixed << std::setprecision(2) << newPrice;
+            recorder->record(ticket, line.str());
+        }
+        return found;
+    }
+
+    // Reservations belong to the UI thread: call these from it, or from a
+    // script replay, which has no UI.
+
+    // Book the smallest table free for the whole sitting at 'start'
+    OpResult makeReservation(const std::string& customerName, const std::string& contactNumber, time_t start,
+        int partySize, ReservationId* madeId = nullptr) {
+        start = ReservationCalendar::slotStart(start);
+        int tableNumber = calendar->findTable(partySize, start);
+        if (tableNumber == -1) {
+            return OpResult::NoTableAvailable;
+        }
+        ReservationId reservationId = bookReservation(customerName, contactNumber, start, partySize, tableNumber);
+        if (madeId != nullptr) {
+            *madeId = reservationId;
+        }
+        return OpResult::Ok;
+    }
+
+    OpResult cancelReservationById(ReservationId reservationId) {
+        const Reservation* reservation = reservations.find(reservationId);
+        if (reservation == nullptr) {
+            return OpResult::ReservationNotFound;
+        }
+
+        // Free the booked slots and show the table's next booking, if any
+        if (reservation->isConfirmed()) {
+            calendar->release(reservation->getTableNumber(), reservation->getStartTime());
+        }
+        cancelNoShow(reservationId);
+        publish(DomainEvent::ReservationCancelled, reservation->getTableNumber(), OrderId(), reservationId,
+            reservation->getPartySize());
+        reservations.remove(reservationId);
+        refreshTableReservations();
+        if (recorder != nullptr) {
+            recorder->record(recorder->nextTicket(), "cancel|" + reservationId.toString());
+        }
+        return OpResult::Ok;
+    }
+
+    OpResult checkInReservationById(ReservationId reservationId) {
+        Reservation* reservation = reservations.find(reservationId);
+        if (reservation == nullptr || !reservation->isConfirmed()) {
+            return OpResult::ReservationNotFound;
+        }
+        cancelNoShow(reservationId);
+        reservation->setStatus(ReservationStatus::Seated);
+        publish(DomainEvent::ReservationSeated, reservation->getTableNumber(), OrderId(), reservationId,
+            reservation->getPartySize());
+        if (recorder != nullptr) {
+            recorder->record(recorder->nextTicket(), "checkin|" + reservationId.toString());
+        }
+        return OpResult::Ok;
+    }
+
+    // Append every successful operation from now on to a script file. Call before run().
+    bool recordScript(const std::string& path) {
+        recorder.reset(new ScriptRecorder(path));
+        if (!recorder->isOpen()) {
+            recorder.reset();
+            return false;
+        }
+        return true;
+    }
+
+    unsigned long long getMenuVersion() const { return menuVersion.load(); }
+
+    // Totals for the consistency checks in the stress test
+    OrderLineFacts::SalesTotals completedSales() {
+        std::lock_guard<std::mutex> lock(analyticsMutex);
+        return salesFacts.salesBetween(0, std::numeric_limits<time_t>::max());
+    }
+
+    long long completedToday() {
+        std::lock_guard<std::mutex> lock(analyticsMutex);
+        const DailySales* today = dailySales.getDay(getCurrentDate());
+        return today != nullptr ? today->orderCount : 0;
+    }
+
+    size_t openOrderCount() {
+        std::lock_guard<std::mutex> lock(orderIndexMutex);
+        return orders.size();
+    }
+
+    unsigned long long rejectedStatusChanges() const { return orders.rejectedTransitionCount(); }
+
+    // Publish kitchen tickets to shared memory for --kitchen-display processes.
+    // Call before run(); only one terminal should feed the displays.
+    bool enableKitchenFeed() {
+        kitchenRing.reset(new KitchenTicketRing(KITCHEN_RING_NAME, true));
+        if (!kitchenRing->isOpen()) {
+            kitchenRing.reset();
+            return false;
+        }
+        return true;
+    }
+
+    // Push kitchen tickets to --kitchen-client processes over a local socket.
+    // Call before run().
+    bool enableKitchenServer(const std::string& socketPath) {
+        kitchenServer.reset(new TwoCli::LineBroadcastServer(socketPath));
+        if (!kitchenServer->start()) {
+            kitchenServer.reset();
+            return false;
+        }
+        return true;
+    }
+
+    // Deliver any events still waiting for the pool
+    void flushEvents() { events.flush(); }
+    unsigned long long eventsPublished() const { return events.getPublished(); }
+    unsigned long long eventsDelivered() const { return events.getDelivered(); }
+    unsigned long long eventBatches() const { return events.getBatches(); }
+
+    std::vector<int> occupiedTableNumbers() {
+        std::vector<int> numbers;
+        for (size_t slot = 0; slot < tables.size(); ++slot) {
+            std::lock_guard<std::mutex> lock(tableLocks[slot]);
+            if (tables[slot].isOccupied()) {
+                numbers.push_back(tables[slot].getTableNumber());
+            }
+        }
+        return numbers;
+    }
+
+private:
+    // Open order by id; caller holds the order's lock
+    const Order* findOpenOrder(OrderId orderId) {
+        std::lock_guard<std::mutex> lock(orderIndexMutex);
+        return orders.find(orderId);
+    }
+
+public:
+    // Table by number in O(1), or nullptr
+    Table* findTable(int tableNumber) {
+        int slot = availability->slotOf(tableNumber);
+        return slot < 0 ? nullptr : &tables[slot];
+    }
 
-    //new 
+    // All occupancy and reservation changes go through these so the bitsets stay in step
+    void setTableOccupied(Table& table, bool occupied) {
+        table.setOccupied(occupied);
+        availability->setOccupied(availability->slotOf(table.getTableNumber()), occupied);
+    }
 
-    bool handleChefMenu(int choice) {
-        switch (choice) {
-        case 1:
-            viewPendingOrders();
-            break;
-        case 2:
-            updateOrderStatus();
-            break;
-        case 3:
-            viewLiveOrders();  // Call the new live monitor function
-            break;
-        case 4:
-            return true; // Return to login
-        default:
-            cout << "Invalid choice. Please try again.\n";
-        }
-        return false;
+    void setTableReservation(Table& table, const std::string& reservationInfo) {
+        table.setReservation(reservationInfo);
+        availability->setReserved(availability->slotOf(table.getTableNumber()), !reservationInfo.empty());
     }
 
-    bool handleManagerMenu(int choice) {
-        switch (choice) {
-        case 1:
-            displayTables();
-            break;
-        case 2:
-            displayAllOrders();
-            break;
-        case 3:
-            manageMenu();
-            break;
-        case 4:
-            generateReports();
-            break;
-        case 5:
-            manageStaff();
-            break;
-        case 6:
-            return true; // Return to login
-        default:
-            std::cout << "Invalid choice. Please try again.\n";
+    // Show each table's next upcoming booking as its reservation
+    void refreshTableReservations() {
+        time_t now = time(0);
+        for (auto& table : tables) {
+            std::string next = calendar->nextBooking(table.getTableNumber(), now);
+            if (next != table.getReservation()) {
+                setTableReservation(table, next);
+            }
         }
-        return false;
     }
 
-    void displayTables() const {
+    void displayTables() {
+        refreshTableReservations();
         std::cout << "\n===== TABLE STATUS =====\n";
         for (const auto& table : tables) {
             table.display();
@@ -805,10 +4354,9 @@ public:
         std::cout << "\nEnter table number to assign: ";
         std::cin >> tableNumber;
 
-        auto it = std::find_if(tables.begin(), tables.end(),
-            [tableNumber](const Table& table) { return table.getTableNumber() == tableNumber; });
+        Table* it = findTable(tableNumber);
 
-        if (it != tables.end()) {
+        if (it != nullptr) {
             if (it->isOccupied()) {
                 std::cout << "Table " << tableNumber << " is already occupied.\n";
             }
@@ -823,12 +4371,16 @@ public:
                 std::cout << "Enter party size: ";
                 std::cin >> partySize;
 
-                if (partySize > it->getCapacity()) {
+                OpResult result = seatParty(tableNumber, partySize);
+                if (result == OpResult::PartyTooLarge) {
                     std::cout << "Party size exceeds table capacity. Please choose a larger table.\n";
                 }
+                else if (result != OpResult::Ok) {
+                    std::cout << opResultToString(result) << ".\n";
+                }
                 else {
-                    it->setOccupied(true);
                     std::cout << "Table " << tableNumber << " assigned to " << customerName << ".\n";
+                    checkInReservation(customerName, time(0));
                 }
             }
         }
@@ -837,18 +4389,32 @@ public:
         }
     }
 
-    void displayReservations() const {
+    // Mark a guest's booking for this sitting as seated so it isn't released as a no-show
+    void checkInReservation(const std::string& customerName, time_t now) {
+        std::string name = ReservationBook::normalizeName(customerName);
+        for (const Reservation* match : reservations.findByNamePrefix(name)) {
+            if (match->isConfirmed() && ReservationBook::normalizeName(match->getCustomerName()) == name &&
+                std::llabs(static_cast<long long>(match->getStartTime() - now)) <= ReservationCalendar::DEFAULT_DURATION_MINUTES * 60) {
+                ReservationId reservationId = match->getReservationId();
+                if (checkInReservationById(reservationId) == OpResult::Ok) {
+                    std::cout << "Reservation " << reservationId << " checked in.\n";
+                }
+                return;
+            }
+        }
+    }
+
+    void displayReservations() {
         std::cout << "\n===== RESERVATIONS =====\n";
 
+        reservations.removeStartedBefore(time(0) - ReservationCalendar::DEFAULT_DURATION_MINUTES * 60);
         if (reservations.empty()) {
             std::cout << "No reservations found.\n";
             return;
         }
 
-        for (const auto& reservation : reservations) {
-            if (reservation.isConfirmed()) {
-                reservation.display();
-            }
+        for (const Reservation* reservation : reservations.byStartTime()) {
+            reservation->display();
         }
     }
 
@@ -869,56 +4435,190 @@ public:
         std::cout << "Enter party size: ";
         std::cin >> partySize;
 
-        // Find available table
-        Table* suitableTable = nullptr;
-        for (auto& table : tables) {
-            if (table.getCapacity() >= partySize && !table.isOccupied() && table.getReservation().empty()) {
-                suitableTable = &table;
-                break;
-            }
-        }
-
-        if (suitableTable == nullptr) {
-            std::cout << "No suitable table available for this party size.\n";
+        time_t start = parseDateTime(dateTime);
+        if (start == static_cast<time_t>(-1)) {
+            std::cout << "Invalid date and time. Please use YYYY-MM-DD HH:MM.\n";
             return;
         }
+        start = ReservationCalendar::slotStart(start);
+
+        // Smallest table free for the whole booking, or the nearest time that has one
+        int tableNumber = calendar->findTable(partySize, start);
+        if (tableNumber == -1) {
+            ReservationCalendar::Opening opening = calendar->nextAvailable(partySize, start, 180,
+                ReservationCalendar::DEFAULT_DURATION_MINUTES, time(0));
+            if (opening.tableNumber == -1) {
+                std::cout << "No suitable table available for this party size near that time.\n";
+                return;
+            }
 
-        std::string reservationId = "R" + std::to_string(nextReservationId++);
-        reservations.push_back(Reservation(reservationId, customerName, contactNumber, dateTime, partySize, suitableTable->getTableNumber()));
-
-        suitableTable->setReservation(customerName + " (" + dateTime + ")");
+            char choice;
+            std::cout << "No table available at that time. The nearest opening is "
+                << formatDateTime(opening.start).substr(0, 16) << " at table " << opening.tableNumber
+                << ". Book it instead? (y/n): ";
+            std::cin >> choice;
+            if (choice != 'y' && choice != 'Y') {
+                std::cout << "Reservation not made.\n";
+                return;
+            }
+            tableNumber = opening.tableNumber;
+            start = opening.start;
+        }
 
+        ReservationId reservationId = bookReservation(customerName, contactNumber, start, partySize, tableNumber);
         std::cout << "Reservation created successfully. Reservation ID: " << reservationId << "\n";
     }
 
     void cancelReservation() {
-        std::string reservationId;
+        std::string reservationIdText;
 
         std::cin.ignore(std::numeric_limits<std::streamsize>::max(), '\n');
         std::cout << "Enter reservation ID to cancel: ";
-        std::getline(std::cin, reservationId);
+        std::getline(std::cin, reservationIdText);
+        ReservationId reservationId = ReservationId::parse(reservationIdText);
 
-        auto it = std::find_if(reservations.begin(), reservations.end(),
-            [&reservationId](const Reservation& reservation) {
-                return reservation.getReservationId() == reservationId && reservation.isConfirmed();
-            });
+        OpResult result = cancelReservationById(reservationId);
+        if (result == OpResult::Ok) {
+            std::cout << "Reservation cancelled successfully.\n";
+        }
+        else {
+            std::cout << opResultToString(result) << ".\n";
+        }
+    }
 
-        if (it != reservations.end()) {
-            it->setConfirmed(false);
+    void findReservation() {
+        int searchType;
+        std::cout << "Find by: 1. Reservation ID  2. Phone Number  3. Customer Name\n";
+        std::cout << "Enter your choice: ";
+        std::cin >> searchType;
 
-            // Clear reservation from table
-            for (auto& table : tables) {
-                if (table.getTableNumber() == it->getTableNumber()) {
-                    table.setReservation("");
-                    break;
-                }
-            }
+        std::string query;
+        std::cin.ignore(std::numeric_limits<std::streamsize>::max(), '\n');
+        std::cout << (searchType == 1 ? "Enter reservation ID: " : searchType == 2 ? "Enter phone number: " : "Enter name or start of name: ");
+        std::getline(std::cin, query);
 
-            std::cout << "Reservation cancelled successfully.\n";
+        std::vector<const Reservation*> found;
+        if (searchType == 1) {
+            if (const Reservation* reservation = reservations.find(ReservationId::parse(query))) {
+                found.push_back(reservation);
+            }
+        }
+        else if (searchType == 2) {
+            found = reservations.findByPhone(query);
+        }
+        else if (searchType == 3) {
+            found = reservations.findByNamePrefix(query);
         }
         else {
-            std::cout << "Reservation not found or already cancelled.\n";
+            std::cout << "Invalid choice.\n";
+            return;
+        }
+
+        if (found.empty()) {
+            std::cout << "No matching reservations.\n";
+            return;
+        }
+        for (const Reservation* reservation : found) {
+            reservation->display();
+        }
+    }
+
+    void addToWaitlist() {
+        std::string customerName;
+        int partySize;
+
+        std::cin.ignore(std::numeric_limits<std::streamsize>::max(), '\n');
+        std::cout << "Enter customer name: ";
+        std::getline(std::cin, customerName);
+
+        std::cout << "Enter party size: ";
+        std::cin >> partySize;
+
+        if (partySize <= 0) {
+            std::cout << "Invalid party size.\n";
+            return;
+        }
+
+        waitlist.push_back(WaitingParty{ customerName, partySize, time(0) });
+        std::cout << customerName << " added to the waitlist (position " << waitlist.size() << ").\n";
+    }
+
+    // Seat as much of the waitlist as possible at once, combining adjacent tables where needed
+    void seatWaitlist() {
+        if (waitlist.empty()) {
+            std::cout << "The waitlist is empty.\n";
+            return;
+        }
+
+        // Free tables that aren't booked for the next sitting
+        time_t now = time(0);
+        std::vector<SeatingOptimizer::FreeTable> freeTables;
+        for (size_t slot = 0; slot < tables.size(); ++slot) {
+            bool occupied;
+            {
+                std::lock_guard<std::mutex> lock(tableLocks[slot]);
+                occupied = tables[slot].isOccupied();
+            }
+            if (!occupied && calendar->isTableFree(tables[slot].getTableNumber(), now)) {
+                freeTables.push_back(SeatingOptimizer::FreeTable{ tables[slot].getTableNumber(), tables[slot].getCapacity() });
+            }
+        }
+
+        std::vector<SeatingOptimizer::Party> parties;
+        for (size_t i = 0; i < waitlist.size(); ++i) {
+            parties.push_back(SeatingOptimizer::Party{ static_cast<int>(i), waitlist[i].partySize });
+        }
+
+        char choice;
+        std::cout << "Search for the best possible seating (up to " << SEATING_SEARCH_BUDGET_MS << " ms)? (y/n): ";
+        std::cin >> choice;
+
+        SeatingOptimizer optimizer(freeTables, parties);
+        bool exact = (choice == 'y' || choice == 'Y');
+        SeatingOptimizer::Plan plan = exact ? optimizer.exact(SEATING_SEARCH_BUDGET_MS) : optimizer.bestFit();
+
+        if (plan.placements.empty()) {
+            std::cout << "No waiting party fits the free tables right now.\n";
+            return;
+        }
+
+        std::vector<char> seated(waitlist.size(), 0);
+        int seatedGuests = 0;
+        int unusedSeats = 0;
+        for (const auto& placement : plan.placements) {
+            const WaitingParty& party = waitlist[placement.partyId];
+            bool joined = placement.secondTable != -1;
+
+            // Another terminal may have seated either table since the plan was made
+            OpResult result = joined ? seatJoinedParty(placement.firstTable, placement.secondTable, party.partySize)
+                : seatParty(placement.firstTable, party.partySize);
+            if (result != OpResult::Ok) {
+                std::cout << party.customerName << " (" << party.partySize << ") stays on the waitlist: "
+                    << opResultToString(result) << ".\n";
+                continue;
+            }
+            std::cout << party.customerName << " (" << party.partySize << ") -> Table " << placement.firstTable;
+            if (joined) {
+                std::cout << " + Table " << placement.secondTable << " (bill on table " << placement.firstTable << ")";
+            }
+            std::cout << ", waited " << (now - party.since) / 60 << " min\n";
+            seated[placement.partyId] = 1;
+            seatedGuests += party.partySize;
+            unusedSeats += placement.seats - party.partySize;
+        }
+
+        std::vector<WaitingParty> stillWaiting;
+        for (size_t i = 0; i < waitlist.size(); ++i) {
+            if (!seated[i]) {
+                stillWaiting.push_back(waitlist[i]);
+            }
         }
+        waitlist.swap(stillWaiting);
+
+        std::cout << "Seated " << seatedGuests << " guests, " << unusedSeats << " seats unused at their tables, "
+            << waitlist.size() << " parties still waiting.\n";
+        std::cout << (exact ? (plan.optimal ? "Best possible seating" : "Best seating found within the time limit") : "Quick seating")
+            << " (" << std::fixed << std::setprecision(3) << plan.millis << " ms)\n" << std::setprecision(2);
     }
 
     void takeOrder() {
@@ -928,10 +4628,9 @@ public:
         std::cout << "\nEnter table number to take order: ";
         std::cin >> tableNumber;
 
-        auto tableIt = std::find_if(tables.begin(), tables.end(),
-            [tableNumber](const Table& table) { return table.getTableNumber() == tableNumber; });
+        Table* tableIt = findTable(tableNumber);
 
-        if (tableIt == tables.end()) {
+        if (tableIt == nullptr) {
             std::cout << "Invalid table number.\n";
             return;
         }
@@ -941,8 +4640,7 @@ public:
             return;
         }
 
-        std::string orderId = "O" + std::to_string(nextOrderId++);
-        Order order(orderId, tableNumber, currentUser->getId());
+        std::vector<OrderLineRequest> lines;
 
         menu.displayMenu();
 
@@ -979,72 +4677,77 @@ public:
             std::cout << "Enter special instructions (or press Enter for none): ";
             std::getline(std::cin, specialInstructions);
 
-            OrderItem orderItem(menuItem, quantity, specialInstructions);
-            order.addItem(orderItem);
+            lines.push_back(OrderLineRequest{ itemId, quantity, specialInstructions });
 
             std::cout << "Item added to order.\n";
         }
 
-        if (order.getItems().empty()) {
+        OrderId orderId;
+        OpResult result = placeOrder(tableNumber, currentUser->getId(), lines, &orderId);
+        if (result == OpResult::EmptyOrder) {
             std::cout << "Order is empty. No order created.\n";
         }
+        else if (result != OpResult::Ok) {
+            std::cout << opResultToString(result) << ". No order created.\n";
+        }
         else {
-            orders.push_back(order);
             std::cout << "Order created successfully. Order ID: " << orderId << "\n";
-            order.display();
+            orders.find(orderId)->display();
         }
-
-        saveOrdersToFile();
     }
 
     void viewOrderStatus() {
-        std::string orderId;
+        std::string orderIdText;
+
+        // List this waiter's orders first so the ID doesn't have to be remembered
+        std::vector<Order*> myOrders = orders.findByWaiter(currentUser->getId());
+        if (!myOrders.empty()) {
+            std::cout << "\nYour orders:\n";
+            for (const Order* order : myOrders) {
+                std::cout << "Order ID: " << order->getOrderId()
+                    << " | Table: " << order->getTableNumber()
+                    << " | Status: " << orderStatusToString(order->getStatus()) << "\n";
+            }
+        }
 
         std::cin.ignore(std::numeric_limits<std::streamsize>::max(), '\n');
         std::cout << "Enter order ID to view status: ";
-        std::getline(std::cin, orderId);
+        std::getline(std::cin, orderIdText);
+        OrderId orderId = OrderId::parse(orderIdText);
 
-        auto it = std::find_if(orders.begin(), orders.end(),
-            [&orderId](const Order& order) { return order.getOrderId() == orderId; });
+        bool found = orders.visit(orderId, [](const Order& order) {
+            std::cout << "Order Status: " << orderStatusToString(order.getStatus()) << "\n";
+            order.display();
+            });
 
-        if (it != orders.end()) {
-            std::cout << "Order Status: " << orderStatusToString(it->getStatus()) << "\n";
-            it->display();
-        }
-        else {
+        if (!found) {
             std::cout << "Order not found.\n";
         }
     }
 
     void serveOrder() {
         std::cout << "\n===== READY ORDERS =====\n";
-        bool foundReadyOrders = false;
+        std::vector<Order*> readyOrders = orders.findByStatus(OrderStatus::Ready);
 
-        for (const auto& order : orders) {
-            if (order.getStatus() == OrderStatus::Ready) {
-                std::cout << "Order ID: " << order.getOrderId() << " | Table: " << order.getTableNumber() << "\n";
-                foundReadyOrders = true;
-            }
+        for (const Order* order : readyOrders) {
+            std::cout << "Order ID: " << order->getOrderId() << " | Table: " << order->getTableNumber() << "\n";
         }
 
-        if (!foundReadyOrders) {
+        if (readyOrders.empty()) {
             std::cout << "No orders ready to serve.\n";
             return;
         }
 
-        std::string orderId;
+        std::string orderIdText;
         std::cin.ignore(std::numeric_limits<std::streamsize>::max(), '\n');
         std::cout << "\nEnter order ID to serve: ";
-        std::getline(std::cin, orderId);
+        std::getline(std::cin, orderIdText);
+        OrderId orderId = OrderId::parse(orderIdText);
 
-        auto it = std::find_if(orders.begin(), orders.end(),
-            [&orderId](Order& order) {
-                return order.getOrderId() == orderId && order.getStatus() == OrderStatus::Ready;
-            });
+        Order* order = orders.find(orderId);
 
-        if (it != orders.end()) {
-            it->updateStatus(OrderStatus::Served);
-            std::cout << "Order " << orderId << " has been served to table " << it->getTableNumber() << ".\n";
+        if (order != nullptr && markServed(orderId) == OpResult::Ok) {
+            std::cout << "Order " << orderId << " has been served to table " << order->getTableNumber() << ".\n";
         }
         else {
             std::cout << "Order not found or not ready to serve.\n";
@@ -1056,56 +4759,39 @@ public:
         std::cout << "Enter table number to generate bill: ";
         std::cin >> tableNumber;
 
-        auto tableIt = std::find_if(tables.begin(), tables.end(),
-            [tableNumber](const Table& table) { return table.getTableNumber() == tableNumber; });
+        bool headerPrinted = false;
+        long long totalCents = 0;
+        OpResult result = settleTable(tableNumber, [&](const Order& order) {
+            if (!headerPrinted) {
+                std::cout << "\n===== BILL FOR TABLE " << tableNumber << " =====\n";
+                headerPrinted = true;
+            }
+            order.generateBill();
+            }, &totalCents);
 
-        if (tableIt == tables.end() || !tableIt->isOccupied()) {
+        if (result == OpResult::InvalidTable || result == OpResult::TableNotOccupied) {
             std::cout << "Invalid table number or table not occupied.\n";
             return;
         }
-
-        std::vector<Order*> tableOrders;
-        for (auto& order : orders) {
-            if (order.getTableNumber() == tableNumber &&
-                (order.getStatus() == OrderStatus::Served || order.getStatus() == OrderStatus::Ready)) {
-                tableOrders.push_back(&order);
-            }
-        }
-
-        if (tableOrders.empty()) {
+        if (result == OpResult::NothingToBill) {
             std::cout << "No active orders found for this table.\n";
             return;
         }
 
-        std::cout << "\n===== BILL FOR TABLE " << tableNumber << " =====\n";
-        double totalAmount = 0.0;
-
-        for (auto& order : tableOrders) {
-            order->generateBill();
-            totalAmount += order->getTotal();
-            order->updateStatus(OrderStatus::Completed);
-        }
-
-        // Free up the table
-        tableIt->setOccupied(false);
-
-        std::cout << "\nTotal bill amount: $" << std::fixed << std::setprecision(2) << totalAmount << "\n";
+        std::cout << "\nTotal bill amount: $" << std::fixed << std::setprecision(2) << totalCents / 100.0 << "\n";
         std::cout << "Thank you for dining at " << restaurantName << "!\n";
     }
 
     void viewPendingOrders() {
         std::cout << "\n===== PENDING ORDERS =====\n";
-        bool foundPendingOrders = false;
+        std::vector<Order*> pendingOrders = orders.findByStatus(OrderStatus::Pending);
 
-        for (const auto& order : orders) {
-            if (order.getStatus() == OrderStatus::Pending) {
-                order.display();
-                std::cout << std::endl;
-                foundPendingOrders = true;
-            }
+        for (const Order* order : pendingOrders) {
+            order->display();
+            std::cout << std::endl;
         }
 
-        if (!foundPendingOrders) {
+        if (pendingOrders.empty()) {
             std::cout << "No pending orders.\n";
         }
     }
@@ -1114,29 +4800,24 @@ public:
         std::cout << "\n===== UPDATE ORDER STATUS =====\n";
         std::cout << "Current orders:\n";
 
-        for (const auto& order : orders) {
-            if (order.getStatus() == OrderStatus::Pending || order.getStatus() == OrderStatus::InProgress) {
-                std::cout << "Order ID: " << order.getOrderId()
-                    << " | Table: " << order.getTableNumber()
-                    << " | Status: " << orderStatusToString(order.getStatus())
-                    << " | Items: " << order.getItems().size() << std::endl;
-            }
+        for (const Order* order : orders.findByStatus({ OrderStatus::Pending, OrderStatus::InProgress })) {
+            std::cout << "Order ID: " << order->getOrderId()
+                << " | Table: " << order->getTableNumber()
+                << " | Status: " << orderStatusToString(order->getStatus())
+                << " | Items: " << order->getItems().size() << std::endl;
         }
 
-        std::string orderId;
+        std::string orderIdText;
         std::cin.ignore(std::numeric_limits<std::streamsize>::max(), '\n');
         std::cout << "\nEnter order ID to update: ";
-        std::getline(std::cin, orderId);
+        std::getline(std::cin, orderIdText);
+        OrderId orderId = OrderId::parse(orderIdText);
 
-        auto it = std::find_if(orders.begin(), orders.end(),
-            [&orderId](Order& order) {
-                return order.getOrderId() == orderId &&
-                    (order.getStatus() == OrderStatus::Pending ||
-                        order.getStatus() == OrderStatus::InProgress);
-            });
+        Order* order = orders.find(orderId);
 
-        if (it != orders.end()) {
-            std::cout << "Current status: " << orderStatusToString(it->getStatus()) << "\n";
+        if (order != nullptr &&
+            (order->getStatus() == OrderStatus::Pending || order->getStatus() == OrderStatus::InProgress)) {
+            std::cout << "Current status: " << orderStatusToString(order->getStatus()) << "\n";
             std::cout << "Select new status:\n";
             std::cout << "1. In Progress\n";
             std::cout << "2. Ready\n";
@@ -1145,12 +4826,10 @@ public:
             std::cout << "Enter choice: ";
             std::cin >> choice;
 
-            if (choice == 1) {
-                it->updateStatus(OrderStatus::InProgress);
+            if (choice == 1 && advanceOrder(orderId, OrderStatus::InProgress) == OpResult::Ok) {
                 std::cout << "Order status updated to In Progress.\n";
             }
-            else if (choice == 2) {
-                it->updateStatus(OrderStatus::Ready);
+            else if (choice == 2 && advanceOrder(orderId, OrderStatus::Ready) == OpResult::Ok) {
                 std::cout << "Order status updated to Ready.\n";
             }
             else {
@@ -1160,34 +4839,294 @@ public:
         else {
             std::cout << "Order not found or not updateable.\n";
         }
-        saveOrdersToFile();
-
     }
 
+    // Today's orders from both the open and archived tiers
     void displayAllOrders() const {
         std::cout << "\n===== ALL ORDERS =====\n";
 
-        if (orders.empty()) {
+        std::string today = getCurrentDate();
+        bool foundOrders = false;
+
+        orders.forEachOrder([&today, &foundOrders](const Order& order) {
+            if (order.getTimestamp().compare(0, 10, today) == 0) {
+                order.display();
+                std::cout << std::endl;
+                foundOrders = true;
+            }
+            });
+
+        if (!foundOrders) {
             std::cout << "No orders found.\n";
-            return;
         }
 
-        for (const auto& order : orders) {
-            order.display();
-            std::cout << std::endl;
+        if (orders.rejectedTransitionCount() > 0) {
+            std::cout << "\nRefused status changes:\n";
+            for (int from = 0; from < ORDER_STATUS_COUNT; ++from) {
+                for (int to = 0; to < ORDER_STATUS_COUNT; ++to) {
+                    unsigned long long count = orders.rejectedTransitions(static_cast<OrderStatus>(from), static_cast<OrderStatus>(to));
+                    if (count > 0) {
+                        std::cout << "  " << orderStatusToString(static_cast<OrderStatus>(from)) << " -> "
+                            << orderStatusToString(static_cast<OrderStatus>(to)) << ": " << count << "\n";
+                    }
+                }
+            }
         }
     }
     // new 
 
 
+    // Order entry only enqueues the id; the kitchen side routes it when it next
+    // looks at its stations. If the queue is ever full, route straight away.
+    void handOffToKitchen(const Order& order) {
+        if (!kitchenHandoff.tryPush(order.getOrderId())) {
+            std::shared_lock<std::shared_mutex> menuLock(menuMutex);
+            std::lock_guard<std::mutex> lock(kitchenMutex);
+            kitchen.route(order, menu, order.getPlacedAt());
+        }
+    }
+
+    void drainKitchenHandoff() {
+        OrderId orderId;
+        while (kitchenHandoff.tryPop(orderId)) {
+            std::lock_guard<std::mutex> orderGuard(orderLock(orderId));
+            const Order* order = findOpenOrder(orderId);
+            if (order != nullptr && (order->getStatus() == OrderStatus::Pending || order->getStatus() == OrderStatus::InProgress)) {
+                std::shared_lock<std::shared_mutex> menuLock(menuMutex);
+                std::lock_guard<std::mutex> lock(kitchenMutex);
+                kitchen.route(*order, menu, order->getPlacedAt());
+            }
+        }
+    }
+
+    void viewStationQueues() {
+        drainKitchenHandoff();
+        std::lock_guard<std::mutex> lock(kitchenMutex);
+        time_t now = time(0);
+        std::cout << "\n===== KITCHEN STATIONS =====\n";
+        for (int index = 0; index < KITCHEN_STATION_COUNT; ++index) {
+            KitchenStation station = static_cast<KitchenStation>(index);
+            KitchenRouter::StationStats stats = kitchen.stats(station, now);
+            std::cout << "\n" << kitchenStationToString(station) << " | Waiting: " << stats.depth
+                << " | Due now: " << stats.dueNow
+                << " | Oldest: " << stats.oldestWaitSeconds / 60 << " min"
+                << " | Average wait: " << std::fixed << std::setprecision(1) << stats.averageWaitMinutes << " min"
+                << " (" << stats.completed << " done)" << std::setprecision(2) << "\n";
+
+            for (const KitchenTicket& ticket : kitchen.upcoming(station)) {
+                std::cout << "  " << ticket.orderId << " | Table " << ticket.tableNumber << " | "
+                    << ticket.quantity << "x " << ticket.itemName;
+                if (!ticket.specialInstructions.empty()) {
+                    std::cout << " (" << ticket.specialInstructions << ")";
+                }
+                if (ticket.fireAt > now) {
+                    std::cout << " | Hold until " << formatDateTime(ticket.fireAt).substr(11, 5);
+                }
+                else {
+                    std::cout << " | Fire now";
+                }
+                std::cout << "\n";
+            }
+        }
+    }
+
+    // Bump the next ticket at a station; an order goes In Progress with its
+    // first finished ticket and Ready with its last
+    void completeStationTicket() {
+        std::cout << "Select station:\n";
+        for (int index = 0; index < KITCHEN_STATION_COUNT; ++index) {
+            std::cout << (index + 1) << ". " << kitchenStationToString(static_cast<KitchenStation>(index)) << "\n";
+        }
+
+        int choice;
+        std::cout << "Enter choice: ";
+        std::cin >> choice;
+        if (choice < 1 || choice > KITCHEN_STATION_COUNT) {
+            std::cout << "Invalid choice.\n";
+            return;
+        }
+
+        drainKitchenHandoff();
+        KitchenTicket done;
+        bool orderDone = false;
+        bool completed;
+        {
+            std::lock_guard<std::mutex> lock(kitchenMutex);
+            completed = kitchen.complete(static_cast<KitchenStation>(choice - 1), time(0), done, orderDone);
+        }
+        if (!completed) {
+            std::cout << "No tickets waiting at this station.\n";
+            return;
+        }
+        std::cout << "Completed " << done.quantity << "x " << done.itemName << " for order " << done.orderId
+            << " (table " << done.tableNumber << ").\n";
+
+        if (!orderDone) {
+            bool pending;
+            {
+                std::lock_guard<std::mutex> lock(orderIndexMutex);
+                const Order* order = orders.find(done.orderId);
+                pending = order != nullptr && order->getStatus() == OrderStatus::Pending;
+            }
+            if (pending) {
+                advanceOrder(done.orderId, OrderStatus::InProgress); // First finished item starts the order
+            }
+        }
+        else if (advanceOrder(done.orderId, OrderStatus::Ready) == OpResult::Ok) {
+            std::cout << "All items for order " << done.orderId << " are done. Order is Ready.\n";
+        }
+    }
+
+    // What a kitchen board last read of kitchen_orders.txt
+    struct KitchenBoardSeen {
+        unsigned long long version = ~0ULL;
+        TwoCli::FileManager<KitchenOrder>::Stamp stamp;
+    };
+
+    // Whether the kitchen export needs rereading. This process's own batches
+    // bump kitchenBoardVersion, so they show at once; other terminals only
+    // change the file, which the stamp catches.
+    bool kitchenBoardChanged(const TwoCli::FileManager<KitchenOrder>& file, KitchenBoardSeen& seen) {
+        unsigned long long version = kitchenBoardVersion.load();
+        TwoCli::FileManager<KitchenOrder>::Stamp stamp = file.stamp();
+        bool changed = version != seen.version || stamp != seen.stamp;
+        seen.version = version;
+        seen.stamp = stamp;
+        return changed;
+    }
+
     void viewLiveOrders() {
         std::cout << "Starting live order monitoring from file..." << std::endl;
 
         // Create a file manager for KitchenOrder
-        TwoCli::FileManager<KitchenOrder> orderManager("kitchen_orders.txt");
+        TwoCli::FileManager<KitchenOrder> orderManager(dataDirectory + "kitchen_orders.txt");
+
+        // Reread only after a terminal has rewritten the file, then print
+        // just the orders that were added, changed status or left the board
+        KitchenBoardSeen seen;
+        auto monitor = TwoCli::makeMonitor<KitchenOrder>(
+            [this, &orderManager, &seen](std::vector<KitchenOrder>& out) {
+                if (!kitchenBoardChanged(orderManager, seen)) {
+                    return false;
+                }
+                orderManager.readRecordsInto(out);
+                return true;
+            },
+            TwoCli::RowRenderer(),
+            TwoCli::diffByKey([](const KitchenOrder& order) { return order.id; }));
+        monitor.run(5, background.get()); // Checked every 5 seconds, reading the file on the pool
+    }
+
+    // Kitchen tickets, table occupancy, orders waiting to be served and the
+    // next arrivals on one screen, refreshed by a single loop thread
+    void viewDashboard() {
+        events.flush(); // Start from everything published so far
+
+        TwoCli::FileManager<KitchenOrder> orderManager(dataDirectory + "kitchen_orders.txt");
+        KitchenBoardSeen seen;
+        TwoCli::Dashboard dashboard(restaurantName + " - LIVE DASHBOARD");
+
+        // Kitchen tickets: the kitchen export file, reread once a terminal has rewritten it
+        dashboard.addPanel<KitchenOrder>("Kitchen tickets",
+            TwoCli::PanelRefresh::onNotify(std::chrono::milliseconds(250), std::chrono::seconds(5)),
+            [this, &orderManager, &seen](std::vector<KitchenOrder>& out) {
+                if (!kitchenBoardChanged(orderManager, seen)) {
+                    return false;
+                }
+                orderManager.readRecordsInto(out);
+                return true;
+            },
+            [](std::ostream& out, const KitchenOrder& order) {
+                out << std::left << std::setw(8) << order.id.toString() << "Table " << std::setw(4) << order.tableNumber
+                    << std::setw(12) << order.status << order.itemList << std::right;
+            },
+            TwoCli::diffByKey([](const KitchenOrder& order) { return order.id; }));
+
+        // Table occupancy: the availability bitsets
+        dashboard.addPanel<TableRow>("Tables",
+            TwoCli::PanelRefresh::onNotify(std::chrono::milliseconds(250)),
+            [this](std::vector<TableRow>& out) {
+                std::lock_guard<std::mutex> lock(floorMutex);
+                out.resize(tables.size());
+                for (size_t slot = 0; slot < tables.size(); ++slot) {
+                    out[slot] = TableRow{ tables[slot].getTableNumber(), tables[slot].getCapacity(),
+                        availability->isOccupied(static_cast<int>(slot)) };
+                }
+                return true;
+            },
+            [](std::ostream& out, const TableRow& row) {
+                out << "Table " << std::left << std::setw(4) << row.tableNumber << "(" << row.capacity << " seats)  "
+                    << (row.occupied ? "Occupied" : "Free") << std::right;
+            });
+
+        // Ready to serve: the order index; also refreshed each half minute as waits grow
+        dashboard.addPanel<ReadyRow>("Ready to serve",
+            TwoCli::PanelRefresh::onNotify(std::chrono::milliseconds(250), std::chrono::seconds(30)),
+            [this](std::vector<ReadyRow>& out) {
+                time_t now = time(0);
+                out.clear();
+                std::lock_guard<std::mutex> lock(orderIndexMutex);
+                for (const Order* order : orders.findByStatus({ OrderStatus::Ready })) {
+                    int itemCount = 0;
+                    for (const auto& item : order->getItems()) {
+                        itemCount += item.getQuantity();
+                    }
+                    out.push_back(ReadyRow{ order->getOrderId(), order->getTableNumber(), itemCount,
+                        static_cast<long long>(now - order->getPlacedAt()) / 60 });
+                }
+                return true;
+            },
+            [](std::ostream& out, const ReadyRow& row) {
+                out << std::left << std::setw(8) << row.orderId.toString() << "Table " << std::setw(4) << row.tableNumber
+                    << row.itemCount << " item(s), placed " << row.waitingMinutes << " min ago" << std::right;
+            });
+
+        // Arrivals: bookings starting within the next few hours, from reservation events
+        dashboard.addPanel<ArrivalRow>("Arrivals (next " + std::to_string(DASHBOARD_ARRIVAL_HOURS) + " hours)",
+            TwoCli::PanelRefresh::onNotify(std::chrono::milliseconds(250), std::chrono::seconds(30)),
+            [this](std::vector<ArrivalRow>& out) {
+                time_t now = time(0);
+                time_t horizon = now + DASHBOARD_ARRIVAL_HOURS * 3600;
+                out.clear();
+                std::lock_guard<std::mutex> lock(floorMutex);
+                for (auto it = expectedArrivals.begin(); it != expectedArrivals.end();) {
+                    const DomainEvent& made = it->second;
+                    if (made.dueAt + NO_SHOW_GRACE_MINUTES * 60 < now) {
+                        it = expectedArrivals.erase(it); // Released as a no-show by now
+                        continue;
+                    }
+                    if (made.dueAt <= horizon) {
+                        out.push_back(ArrivalRow{ made.reservationId, made.dueAt, made.tableNumber, made.partySize,
+                            static_cast<long long>(made.dueAt - now) / 60 });
+                    }
+                    ++it;
+                }
+                std::sort(out.begin(), out.end(), [](const ArrivalRow& a, const ArrivalRow& b) { return a.dueAt < b.dueAt; });
+                return true;
+            },
+            [](std::ostream& out, const ArrivalRow& row) {
+                out << std::left << std::setw(8) << row.reservationId.toString() << formatDateTime(row.dueAt).substr(11, 5)
+                    << "  Table " << std::setw(4) << row.tableNumber << "party of " << row.partySize << ", ";
+                if (row.minutesAway >= 0) {
+                    out << "in " << row.minutesAway << " min";
+                }
+                else {
+                    out << -row.minutesAway << " min late";
+                }
+                out << std::right;
+            });
 
-        // Start the watch function
-        orderManager.watch(5); // Refresh every 5 seconds
+        {
+            std::lock_guard<std::mutex> lock(dashboardMutex);
+            openDashboard = &dashboard;
+        }
+        dashboard.runUntilEnter();
+        {
+            std::lock_guard<std::mutex> lock(dashboardMutex);
+            openDashboard = nullptr;
+        }
+        std::cout << "Dashboard drew " << dashboard.getFrames() << " frame(s) from "
+            << dashboard.getRefreshes() << " panel refresh(es).\n";
     }
     //
 
@@ -1254,7 +5193,7 @@ public:
         std::cin >> price;
 
         MenuItem newItem(id, name, category, description, price);
-        menu.addItem(newItem);
+        editMenu([&]() { menu.addItem(newItem); });
 
         std::cout << "Menu item added successfully.\n";
     }
@@ -1279,7 +5218,7 @@ public:
         int choice;
         std::cin >> choice;
 
-        menu.updateItemAvailability(itemId, choice == 1);
+        editMenu([&]() { menu.updateItemAvailability(itemId, choice == 1); });
     }
 
     void updateItemPrice() {
@@ -1302,7 +5241,9 @@ public:
         double newPrice;
         std::cin >> newPrice;
 
-        menu.updateItemPrice(itemId, newPrice);
+        if (setMenuItemPrice(itemId, newPrice)) {
+            std::cout << "Item price updated successfully.\n";
+        }
     }
 
     void removeMenuItem() {
@@ -1313,7 +5254,7 @@ public:
         std::cout << "\nEnter item ID to remove: ";
         std::getline(std::cin, itemId);
 
-        menu.removeItem(itemId);
+        editMenu([&]() { menu.removeItem(itemId); });
     }
 
     void generateReports() {
@@ -1321,7 +5262,8 @@ public:
         std::cout << "1. Daily Sales Report\n";
         std::cout << "2. Popular Items Report\n";
         std::cout << "3. Table Occupancy Report\n";
-        std::cout << "4. Return to Previous Menu\n";
+        std::cout << "4. Background Task Report\n";
+        std::cout << "5. Return to Previous Menu\n";
 
         int choice;
         std::cout << "\nEnter your choice: ";
@@ -1338,132 +5280,220 @@ public:
             generateTableOccupancyReport();
             break;
         case 4:
+            generateBackgroundTaskReport();
+            break;
+        case 5:
             return;
         default:
             std::cout << "Invalid choice.\n";
         }
     }
 
-    void generateDailySalesReport() const {
+    void generateDailySalesReport() {
         // Get today's date
-        time_t now = time(0);
-        struct tm tstruct;
-        char dateBuffer[11];
-        tstruct = *localtime(&now);
-        strftime(dateBuffer, sizeof(dateBuffer), "%Y-%m-%d", &tstruct);
-        std::string today(dateBuffer);
+        std::string today = getCurrentDate();
 
         std::cout << "\n===== DAILY SALES REPORT: " << today << " =====\n";
 
-        double totalSales = 0.0;
-        int totalOrders = 0;
+        // Kept up to date as orders are billed, so there is nothing to scan
+        DailySales totals;
+        if (const DailySales* day = dailySales.getDay(today)) {
+            totals = *day;
+        }
 
-        for (const auto& order : orders) {
-            if (order.getStatus() == OrderStatus::Completed && order.getTimestamp().substr(0, 10) == today) {
-                totalSales += order.getTotal();
-                totalOrders++;
+        std::cout << "Total Orders: " << totals.orderCount << std::endl;
+        std::cout << "Total Sales: $" << std::fixed << std::setprecision(2) << totals.subtotalCents / 100.0 << std::endl;
+        std::cout << "GST Collected: $" << totals.gstCents / 100.0 << std::endl;
+        std::cout << "Gross Takings: $" << totals.grossCents() / 100.0 << std::endl;
+        std::cout << "Average Order Value: $" << totals.averageTicket() << std::endl;
+
+        if (totals.orderCount > 0) {
+            std::cout << "\nSales by hour:" << std::endl;
+            for (int hour = 0; hour < 24; ++hour) {
+                if (totals.hourlyOrders[hour] > 0) {
+                    std::cout << "  " << std::right << std::setfill('0') << std::setw(2) << hour << ":00" << std::setfill(' ')
+                        << "  " << std::left << std::setw(4) << totals.hourlyOrders[hour] << " orders  $"
+                        << totals.hourlySubtotalCents[hour] / 100.0 << std::endl;
+                }
             }
         }
 
-        std::cout << "Total Orders: " << totalOrders << std::endl;
-        std::cout << "Total Sales: $" << std::fixed << std::setprecision(2) << totalSales << std::endl;
-        std::cout << "Average Order Value: $" << (totalOrders > 0 ? totalSales / totalOrders : 0) << std::endl;
-
         // Option to save report to file
         std::cout << "\nWould you like to save this report to a file? (y/n): ";
         char saveChoice;
-        std::cin >> saveChoice;
-
-        if (saveChoice == 'y' || saveChoice == 'Y') {
-            std::string filename = "sales_report_" + today + ".txt";
-            std::ofstream reportFile(filename);
-
-            if (reportFile.is_open()) {
-                reportFile << "===== EATS & TREATS DAILY SALES REPORT =====" << std::endl;
-                reportFile << "Date: " << today << std::endl;
-                reportFile << "Total Orders: " << totalOrders << std::endl;
-                reportFile << "Total Sales: $" << std::fixed << std::setprecision(2) << totalSales << std::endl;
-                reportFile << "Average Order Value: $" << (totalOrders > 0 ? totalSales / totalOrders : 0) << std::endl;
-
-                reportFile.close();
-                std::cout << "Report saved to " << filename << std::endl;
-            }
-            else {
-                std::cout << "Error: Could not open file for writing." << std::endl;
-            }
-        }
-    }
-
-    void generatePopularItemsReport() const {
-        std::cout << "\n===== POPULAR ITEMS REPORT =====\n";
-
-        // Map to track item popularity
-        std::map<std::string, int> itemCounts;
-
-        // Count items across all completed orders
-        for (const auto& order : orders) {
-            if (order.getStatus() == OrderStatus::Completed) {
-                for (const auto& item : order.getItems()) {
-                    itemCounts[item.getMenuItem()->getId()] += item.getQuantity();
-                }
-            }
+        std::cin >> saveChoice;
+
+        if (saveChoice == 'y' || saveChoice == 'Y') {
+            std::string filename = "sales_report_" + today + ".txt";
+            std::ostringstream report;
+            report << "===== EATS & TREATS DAILY SALES REPORT =====" << std::endl;
+            report << "Date: " << today << std::endl;
+            report << "Total Orders: " << totals.orderCount << std::endl;
+            report << "Total Sales: $" << std::fixed << std::setprecision(2) << totals.subtotalCents / 100.0 << std::endl;
+            report << "GST Collected: $" << totals.gstCents / 100.0 << std::endl;
+            report << "Gross Takings: $" << totals.grossCents() / 100.0 << std::endl;
+            report << "Average Order Value: $" << totals.averageTicket() << std::endl;
+
+            // The write happens on the pool; the outcome is shown at the next menu
+            std::string text = report.str();
+            background->submit([filename, text]() {
+                std::ofstream reportFile(filename);
+                reportFile << text;
+                return reportFile.good();
+                }, TwoCli::TaskPriority::Low)
+                .then([this, filename](bool saved) {
+                backgroundNotices.post(saved ? "Report saved to " + filename : "Error: Could not write " + filename + ".");
+                    }, TwoCli::TaskPriority::Low);
+            std::cout << "Saving report to " << filename << " in the background." << std::endl;
         }
+    }
 
-        // Convert to vector for sorting
-        std::vector<std::pair<std::string, int>> sortedItems(itemCounts.begin(), itemCounts.end());
-        std::sort(sortedItems.begin(), sortedItems.end(),
-            [](const auto& a, const auto& b) { return a.second > b.second; });
+    void generateBackgroundTaskReport() const {
+        TwoCli::WorkStealingPool::Stats stats = background->stats();
+        std::cout << "\n===== BACKGROUND TASK REPORT =====\n";
+        std::cout << "Workers: " << stats.workers << ", queued now: " << stats.queued
+            << ", most queued at once: " << stats.peakQueued << ", stolen: " << stats.stolen << std::endl;
+        std::cout << "Queue depth by worker:";
+        for (size_t depth : stats.depthByWorker) {
+            std::cout << " " << depth;
+        }
+        std::cout << std::endl << std::endl;
+
+        std::cout << std::left << std::setw(10) << "Priority" << std::setw(10) << "Tasks"
+            << std::setw(16) << "Avg wait (us)" << std::setw(16) << "Max wait (us)" << "Avg run (us)" << std::endl;
+        std::cout << std::string(64, '-') << std::endl;
+        for (int priority = 0; priority < TwoCli::TASK_PRIORITY_COUNT; ++priority) {
+            const TwoCli::WorkStealingPool::PriorityStats& row = stats.byPriority[priority];
+            std::cout << std::left << std::setw(10) << TwoCli::taskPriorityToString(static_cast<TwoCli::TaskPriority>(priority))
+                << std::setw(10) << row.executed << std::fixed << std::setprecision(1)
+                << std::setw(16) << row.averageWaitMicros << std::setw(16) << row.maxWaitMicros
+                << row.averageRunMicros << std::endl;
+        }
+    }
 
-        // Display top items
-        std::cout << "Top ordered items:" << std::endl;
+    void printTopItems(const std::string& title, const std::vector<RankedItem>& ranked) const {
+        std::cout << "\n" << title << ":" << std::endl;
+        if (ranked.empty()) {
+            std::cout << "No completed orders in this period." << std::endl;
+            return;
+        }
         std::cout << std::left << std::setw(10) << "Rank"
             << std::setw(10) << "ID"
             << std::setw(30) << "Name"
             << "Quantity Ordered" << std::endl;
         std::cout << std::string(60, '-') << std::endl;
 
-        int rank = 1;
-        for (const auto& item : sortedItems) {
-            if (rank > 10) break; // Show top 10
+        for (size_t rank = 1; rank <= ranked.size(); ++rank) {
+            const RankedItem& item = ranked[rank - 1];
+            std::cout << std::left << std::setw(10) << rank
+                << std::setw(10) << item.itemId
+                << std::setw(30) << item.itemName
+                << item.quantity << std::endl;
+        }
+    }
+
+    void generatePopularItemsReport() {
+        std::cout << "\n===== POPULAR ITEMS REPORT =====\n";
+
+        // Recent windows come straight from the live counters
+        time_t now = time(0);
+        printTopItems("Hot in the last hour", popularItems.top(PopularItemsTracker::LastHour, 10, now));
+        printTopItems("Top today", popularItems.top(PopularItemsTracker::Today, 10, now));
+        printTopItems("Top in the last 7 days", popularItems.top(PopularItemsTracker::LastWeek, 10, now));
 
-            const MenuItem* menuItem = menu.findItem(item.first);
-            if (menuItem) {
-                std::cout << std::left << std::setw(10) << rank
-                    << std::setw(10) << menuItem->getId()
-                    << std::setw(30) << menuItem->getName()
-                    << item.second << std::endl;
+        // Count items across all completed orders
+        std::vector<long long> itemCounts = salesFacts.quantityByItem(std::numeric_limits<time_t>::min(),
+            std::numeric_limits<time_t>::max());
+
+        // Only the top 10 need to be in order
+        std::vector<uint32_t> sortedItems;
+        for (uint32_t handle = 0; handle < itemCounts.size(); ++handle) {
+            if (itemCounts[handle] > 0) {
+                sortedItems.push_back(handle);
             }
-            rank++;
         }
+        size_t shown = std::min<size_t>(10, sortedItems.size());
+        std::partial_sort(sortedItems.begin(), sortedItems.begin() + shown, sortedItems.end(),
+            [&itemCounts](uint32_t a, uint32_t b) { return itemCounts[a] > itemCounts[b]; });
+
+        std::vector<RankedItem> allTime;
+        for (size_t i = 0; i < shown; ++i) {
+            uint32_t handle = sortedItems[i];
+            allTime.push_back(RankedItem{ salesFacts.getItemId(handle), salesFacts.getItemName(handle), itemCounts[handle] });
+        }
+        printTopItems("Top ordered items (all time)", allTime);
     }
 
-    void generateTableOccupancyReport() const {
+    void generateTableOccupancyReport() {
+        events.flush(); // Let the occupancy history catch up
+        refreshTableReservations();
         std::cout << "\n===== TABLE OCCUPANCY REPORT =====\n";
 
         int totalTables = static_cast<int>(tables.size()); // Fix for size_t to int conversion warning
-        int occupiedTables = 0;
-        int reservedTables = 0;
-
-        for (const auto& table : tables) {
-            if (table.isOccupied()) {
-                occupiedTables++;
-            }
-            if (!table.getReservation().empty()) {
-                reservedTables++;
-            }
-        }
+        int occupiedTables = availability->occupiedCount();
 
         std::cout << "Total Tables: " << totalTables << std::endl;
         std::cout << "Currently Occupied: " << occupiedTables << " ("
             << (totalTables > 0 ? (occupiedTables * 100.0 / totalTables) : 0) << "%)" << std::endl;
-        std::cout << "Reserved (Not Occupied): " << (reservedTables - occupiedTables) << std::endl;
+        std::cout << "Reserved (Not Occupied): " << availability->reservedNotOccupiedCount() << std::endl;
         std::cout << "Available: " << (totalTables - occupiedTables) << " ("
             << (totalTables > 0 ? ((totalTables - occupiedTables) * 100.0 / totalTables) : 0) << "%)" << std::endl;
+        for (const auto& capacityClass : availability->freeCountsByCapacity()) {
+            std::cout << "  Free " << capacityClass.first << "-seat tables: " << capacityClass.second << std::endl;
+        }
 
         std::cout << "\nDetailed Table Status:" << std::endl;
         for (const auto& table : tables) {
             table.display();
         }
+
+        // Trends from the occupancy time series
+        time_t now = time(0);
+        const std::pair<const char*, time_t> periods[] = { { "Last 24 hours", 24 * 3600 }, { "Last 7 days", 7 * 24 * 3600 } };
+        for (const auto& period : periods) {
+            OccupancyHistory::Summary summary = occupancyHistory->summarize(period.second, now);
+            std::cout << "\n" << period.first << ":" << std::endl;
+            std::cout << "  Average Seat Utilization: " << std::fixed << std::setprecision(1)
+                << summary.seatUtilization * 100.0 << "%" << std::endl;
+            std::cout << "  Average Table Utilization: " << summary.tableUtilization * 100.0 << "%" << std::endl;
+            std::cout << "  Table Turns: " << summary.turns;
+            if (summary.turns > 0) {
+                std::cout << " (average " << summary.averageTurnMinutes << " minutes)";
+            }
+            std::cout << std::endl;
+            if (summary.peakHourStart != 0) {
+                std::cout << "  Peak Hour: " << formatDateTime(summary.peakHourStart).substr(0, 16)
+                    << " (" << summary.peakHourTables << " tables on average)" << std::endl;
+            }
+        }
+
+        std::vector<OccupancyHistory::Event> recent = occupancyHistory->recentEvents(5);
+        if (!recent.empty()) {
+            std::cout << "\nRecent Activity:" << std::endl;
+            for (const auto& event : recent) {
+                std::cout << "  " << formatDateTime(event.when) << "  Table " << event.tableNumber
+                    << (event.seated ? " seated (" : " freed (") << event.partySize << " guests)" << std::endl;
+            }
+        }
+        std::cout << std::setprecision(2);
+    }
+
+    // Close the service shift and hand the shift's order memory back in one go
+    void endShift() {
+        std::cout << "\n===== END OF SHIFT =====\n";
+
+        if (!orders.empty()) {
+            std::cout << orders.size() << " order(s) are still open. Bill or cancel them before ending the shift.\n";
+            return;
+        }
+
+        if (shiftArena.isEnabled()) {
+            std::cout << "Shift arena used " << shiftArena.getBlockCount() << " block(s), "
+                << shiftArena.getBytesReserved() / 1024 << " KB.\n";
+            shiftArena.release();
+            std::cout << "Order memory released.\n";
+        }
+        std::cout << "Shift closed.\n";
     }
 
     void manageStaff() {
@@ -1547,9 +5577,972 @@ public:
     }
 };
 
+// One front-of-house device working on a shared RestaurantSystem. Each
+// session can run on its own thread; calls go straight to the system's core
+// operations, which lock only the table or order involved.
+class TerminalSession {
+private:
+    RestaurantSystem& system;
+    std::string userId;
+
+public:
+    TerminalSession(RestaurantSystem& system, const std::string& userId)
+        : system(system), userId(userId) {
+    }
+
+    OpResult seat(int tableNumber, int partySize) {
+        return system.seatParty(tableNumber, partySize);
+    }
+
+    OpResult placeOrder(int tableNumber, const std::vector<OrderLineRequest>& lines,
+        OrderId* placedId = nullptr, long long* subtotalCents = nullptr) {
+        return system.placeOrder(tableNumber, userId, lines, placedId, subtotalCents);
+    }
+
+    OpResult startCooking(OrderId orderId) { return system.advanceOrder(orderId, OrderStatus::InProgress); }
+    OpResult markReady(OrderId orderId) { return system.advanceOrder(orderId, OrderStatus::Ready); }
+    OpResult serve(OrderId orderId) { return system.markServed(orderId); }
+
+    OpResult settle(int tableNumber, long long* billedCents = nullptr) {
+        return system.settleTable(tableNumber, nullptr, billedCents);
+    }
+
+    const std::string& getUserId() const { return userId; }
+};
+
+// Replays a transaction script against a RestaurantSystem at full speed,
+// timing each command. One command per line, '#' starts a comment, fields
+// are separated by '|' and escaped like archive fields:
+//   seat|<table>|<party>
+//   join|<table>|<next table>|<party>
+//   order|<ref>|<table>|<waiter>|<item>,<qty>[,<instructions>];...
+//   start|<ref>    ready|<ref>    serve|<ref>
+//   settle|<table>
+//   reserve|<ref>|<name>|<phone>|<YYYY-MM-DD HH:MM>|<party>
+//   cancel|<ref>    checkin|<ref>
+//   price|<item>|<price>
+// A <ref> names an order or reservation within the script. Scripts written
+// by --record-script use the ids the shift had; the replay maps them to the
+// ids it is given.
+class ScriptRunner {
+public:
+    enum CommandKind {
+        SeatCommand, OrderCommand, StartCommand, ReadyCommand, ServeCommand,
+        SettleCommand, ReserveCommand, CancelCommand, PriceCommand, JoinCommand, CheckInCommand
+    };
+    static const int COMMAND_KIND_COUNT = 11;
+
+    static const char* commandName(CommandKind kind) {
+        static const char* names[COMMAND_KIND_COUNT] = { "seat", "order", "start", "ready", "serve", "settle", "reserve", "cancel",
+            "price", "join", "checkin" };
+        return names[kind];
+    }
+
+private:
+    // Parsed ahead of the run so only the system's own work is timed
+    struct Command {
+        CommandKind kind;
+        int lineNumber;
+        std::string ref;       // order, start, ready, serve, reserve, cancel, checkin
+        int number;            // Table number
+        int secondNumber;      // join: the table joined to 'number'
+        int partySize;         // seat, join, reserve
+        std::string text;      // order: waiter; reserve: name; price: item
+        std::string contact;   // reserve
+        time_t start;          // reserve
+        double price;          // price
+        std::vector<OrderLineRequest> lines; // order
+    };
+
+    RestaurantSystem& system;
+    std::vector<Command> commands;
+    std::unordered_map<std::string, OrderId> orderRefs;
+    std::unordered_map<std::string, ReservationId> reservationRefs;
+    std::vector<long long> latencyNanos[COMMAND_KIND_COUNT];
+    long long failures[COMMAND_KIND_COUNT] = {};
+    std::vector<std::string> failureSamples; // The first few, for the report
+    double elapsedSeconds = 0;
+
+    static const size_t FAILURE_SAMPLES = 5;
+
+    static bool parseNumber(const std::string& text, int& value) {
+        char* end = nullptr;
+        long parsed = std::strtol(text.c_str(), &end, 10);
+        if (text.empty() || *end != '\0') {
+            return false;
+        }
+        value = static_cast<int>(parsed);
+        return true;
+    }
+
+    // Fills 'command' from one script line; false if it doesn't parse
+    static bool parseCommand(const std::vector<std::string>& fields, Command& command) {
+        static const size_t fieldCounts[COMMAND_KIND_COUNT] = { 3, 5, 2, 2, 2, 2, 6, 2, 3, 4, 2 };
+        int kind = 0;
+        while (kind < COMMAND_KIND_COUNT && fields[0] != commandName(static_cast<CommandKind>(kind))) {
+            ++kind;
+        }
+        if (kind == COMMAND_KIND_COUNT || fields.size() != fieldCounts[kind]) {
+            return false;
+        }
+        command.kind = static_cast<CommandKind>(kind);
+        switch (command.kind) {
+        case SeatCommand:
+            return parseNumber(fields[1], command.number) && parseNumber(fields[2], command.partySize);
+        case JoinCommand:
+            return parseNumber(fields[1], command.number) && parseNumber(fields[2], command.secondNumber)
+                && parseNumber(fields[3], command.partySize);
+        case OrderCommand:
+            command.ref = fields[1];
+            command.text = unescapeField(fields[3]);
+            return parseNumber(fields[2], command.number) && parseOrderLines(fields[4], command.lines);
+        case SettleCommand:
+            return parseNumber(fields[1], command.number);
+        case ReserveCommand:
+            command.ref = fields[1];
+            command.text = unescapeField(fields[2]);
+            command.contact = unescapeField(fields[3]);
+            command.start = parseDateTime(fields[4]);
+            return command.start != static_cast<time_t>(-1) && parseNumber(fields[5], command.partySize);
+        case PriceCommand: {
+            command.text = unescapeField(fields[1]);
+            char* end = nullptr;
+            command.price = std::strtod(fields[2].c_str(), &end);
+            return !fields[2].empty() && *end == '\0' && command.price >= 0;
+        }
+        default:
+            command.ref = fields[1];
+            return !command.ref.empty();
+        }
+    }
+
+    OpResult execute(const Command& command) {
+        switch (command.kind) {
+        case SeatCommand:
+            return system.seatParty(command.number, command.partySize);
+        case JoinCommand:
+            return system.seatJoinedParty(command.number, command.secondNumber, command.partySize);
+        case OrderCommand: {
+            OrderId placed;
+            OpResult result = system.placeOrder(command.number, command.text, command.lines, &placed);
+            if (result == OpResult::Ok) {
+                orderRefs[command.ref] = placed;
+            }
+            return result;
+        }
+        case StartCommand:
+        case ReadyCommand:
+        case ServeCommand: {
+            auto ref = orderRefs.find(command.ref);
+            if (ref == orderRefs.end()) {
+                return OpResult::OrderNotFound;
+            }
+            if (command.kind == ServeCommand) {
+                return system.markServed(ref->second);
+            }
+            return system.advanceOrder(ref->second, command.kind == StartCommand ? OrderStatus::InProgress : OrderStatus::Ready);
+        }
+        case SettleCommand:
+            return system.settleTable(command.number);
+        case ReserveCommand: {
+            ReservationId made;
+            OpResult result = system.makeReservation(command.text, command.contact, command.start, command.partySize, &made);
+            if (result == OpResult::Ok) {
+                reservationRefs[command.ref] = made;
+            }
+            return result;
+        }
+        case CancelCommand:
+        case CheckInCommand: {
+            auto ref = reservationRefs.find(command.ref);
+            if (ref == reservationRefs.end()) {
+                return OpResult::ReservationNotFound;
+            }
+            return command.kind == CancelCommand ? system.cancelReservationById(ref->second)
+                : system.checkInReservationById(ref->second);
+        }
+        case PriceCommand:
+            return system.setMenuItemPrice(command.text, command.price) ? OpResult::Ok : OpResult::UnknownItem;
+        }
+        return OpResult::InvalidTransition;
+    }
+
+    // Nearest-rank percentile of sorted samples, in microseconds
+    static double percentileMicros(const std::vector<long long>& sorted, double fraction) {
+        size_t rank = static_cast<size_t>(std::ceil(fraction * sorted.size()));
+        return sorted[rank > 0 ? rank - 1 : 0] / 1000.0;
+    }
+
+public:
+    explicit ScriptRunner(RestaurantSystem& system) : system(system) {}
+
+    // Read and check the whole script; on failure 'error' names the bad line
+    bool load(const std::string& path, std::string& error) {
+        std::ifstream file(path);
+        if (!file.is_open()) {
+            error = "Could not open " + path;
+            return false;
+        }
+        std::string line;
+        int lineNumber = 0;
+        while (std::getline(file, line)) {
+            ++lineNumber;
+            if (!line.empty() && line.back() == '\r') {
+                line.pop_back();
+            }
+            if (line.empty() || line[0] == '#') {
+                continue;
+            }
+            Command command = {};
+            command.lineNumber = lineNumber;
+            if (!parseCommand(splitFields(line, '|'), command)) {
+                error = path + ":" + std::to_string(lineNumber) + ": cannot parse '" + line + "'";
+                return false;
+            }
+            commands.push_back(std::move(command));
+        }
+        for (auto& samples : latencyNanos) {
+            samples.reserve(commands.size());
+        }
+        return true;
+    }
+
+    // Run every command once, in order; returns how many failed
+    long long run() {
+        auto started = std::chrono::steady_clock::now();
+        for (const Command& command : commands) {
+            auto before = std::chrono::steady_clock::now();
+            OpResult result = execute(command);
+            auto after = std::chrono::steady_clock::now();
+            latencyNanos[command.kind].push_back(std::chrono::duration_cast<std::chrono::nanoseconds>(after - before).count());
+            if (result != OpResult::Ok) {
+                failures[command.kind]++;
+                if (failureSamples.size() < FAILURE_SAMPLES) {
+                    failureSamples.push_back("line " + std::to_string(command.lineNumber) + " (" + commandName(command.kind)
+                        + "): " + opResultToString(result));
+                }
+            }
+        }
+        elapsedSeconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - started).count();
+
+        long long failed = 0;
+        for (long long count : failures) {
+            failed += count;
+        }
+        return failed;
+    }
+
+    void printReport() {
+        std::cout << "Replayed " << commands.size() << " commands in " << std::fixed << std::setprecision(3) << elapsedSeconds
+            << " s (" << std::setprecision(0) << commands.size() / std::max(elapsedSeconds, 1e-9) << " commands/s)\n\n";
+        std::cout << std::left << std::setw(10) << "Command" << std::right << std::setw(9) << "Count" << std::setw(9) << "Failed"
+            << std::setw(11) << "p50 us" << std::setw(11) << "p95 us" << std::setw(11) << "p99 us" << std::setw(11) << "max us" << "\n";
+        std::cout << std::setprecision(1);
+        for (int kind = 0; kind < COMMAND_KIND_COUNT; ++kind) {
+            std::vector<long long>& samples = latencyNanos[kind];
+            if (samples.empty()) {
+                continue;
+            }
+            std::sort(samples.begin(), samples.end());
+            std::cout << std::left << std::setw(10) << commandName(static_cast<CommandKind>(kind)) << std::right
+                << std::setw(9) << samples.size() << std::setw(9) << failures[kind]
+                << std::setw(11) << percentileMicros(samples, 0.50) << std::setw(11) << percentileMicros(samples, 0.95)
+                << std::setw(11) << percentileMicros(samples, 0.99) << std::setw(11) << samples.back() / 1000.0 << "\n";
+        }
+        for (const std::string& sample : failureSamples) {
+            std::cout << "Failed: " << sample << "\n";
+        }
+        std::cout.unsetf(std::ios::fixed);
+    }
+};
+
+// Replay a transaction script in a scratch data directory and report
+// throughput and per-command latency. Exits non-zero if any command failed.
+int runScript(const std::string& path) {
+    std::filesystem::path scratch = std::filesystem::temp_directory_path() /
+        ("eats_script_" + std::to_string(static_cast<long long>(time(0))) + "_" + std::to_string(std::rand()));
+    std::filesystem::create_directories(scratch);
+    int status = 0;
+    {
+        RestaurantSystem system("Script Replay", 0, false, scratch.string() + "/");
+        ScriptRunner runner(system);
+        std::string error;
+        if (!runner.load(path, error)) {
+            std::cerr << error << std::endl;
+            status = 2;
+        }
+        else {
+            long long failed = runner.run();
+            runner.printReport();
+            system.flushEvents();
+            std::cout << "Events: " << system.eventsPublished() << " published, " << system.eventsDelivered() << " delivered\n";
+            status = failed == 0 ? 0 : 1;
+        }
+    }
+    std::filesystem::remove_all(scratch);
+    return status;
+}
+
+// Builds a shift's worth of orders with and without the shift arena so the two
+// allocation strategies can be compared. Run once per mode; peak RSS is per process.
+int runAllocationBenchmark(const std::string& mode, int orderCount) {
+    if (mode != "heap" && mode != "arena") {
+        std::cerr << "Usage: --bench-alloc <heap|arena> [orders]" << std::endl;
+        return 1;
+    }
+
+    const int ITEMS_PER_ORDER = 4;
+    Menu menu;
+    std::vector<MenuItem> menuItems = menu.getItems();
+    const std::string instructions[] = { "", "no peanuts, extra chilli on the side", "less sugar please", "allergy: shellfish - check with chef" };
+
+    long long rssBefore = getPeakRssKb();
+    CountingResource heapCounter;
+    ShiftArena arena(true);
+    std::pmr::memory_resource* resource = (mode == "arena") ? arena.resource() : &heapCounter;
+
+    std::vector<Order> shift;
+    shift.reserve(orderCount);
+
+    auto buildStart = std::chrono::steady_clock::now();
+    for (int i = 0; i < orderCount; ++i) {
+        Order order(OrderId::make(0, i + 1), i % 10 + 1, "W001", resource);
+        for (int j = 0; j < ITEMS_PER_ORDER; ++j) {
+            const MenuItem& item = menuItems[(i + j) % menuItems.size()];
+            order.addItem(&item, j + 1, instructions[(i + j) % 4]);
+        }
+        shift.push_back(std::move(order));
+    }
+    auto buildEnd = std::chrono::steady_clock::now();
+
+    size_t allocations = (mode == "arena") ? arena.getBlockCount() : heapCounter.getAllocations();
+    size_t bytes = (mode == "arena") ? arena.getBytesReserved() : heapCounter.getPeakBytesInUse();
+    long long rssPeak = getPeakRssKb();
+
+    shift.clear();
+    arena.release();
+    auto teardownEnd = std::chrono::steady_clock::now();
+
+    std::cout << "Allocation benchmark: " << mode << " mode, " << orderCount << " orders x " << ITEMS_PER_ORDER << " items" << std::endl;
+    std::cout << "Heap allocations for order data: " << allocations << std::endl;
+    std::cout << "Bytes taken from the heap: " << bytes << std::endl;
+    std::cout << "Build time: " << std::chrono::duration_cast<std::chrono::microseconds>(buildEnd - buildStart).count() / 1000.0 << " ms" << std::endl;
+    std::cout << "Teardown time: " << std::chrono::duration_cast<std::chrono::microseconds>(teardownEnd - buildEnd).count() / 1000.0 << " ms" << std::endl;
+    std::cout << "Peak RSS: " << rssPeak << " KB (" << (rssPeak - rssBefore) << " KB above start)" << std::endl;
+    return 0;
+}
+
+// Fills the order-line store with a year of synthetic lines and times the
+// report queries over it
+int runFactStoreBenchmark(int rowCount) {
+    const int DAYS = 365;
+    Menu menu;
+    std::vector<MenuItem> menuItems = menu.getItems();
+    OrderLineFacts facts;
+
+    time_t yearStart = startOfDay(time(0), -DAYS + 1);
+    int rowsPerDay = std::max(1, rowCount / DAYS);
+    for (int row = 0; row < rowCount; ++row) {
+        const MenuItem& item = menuItems[row % menuItems.size()];
+        time_t placedAt = yearStart + (row / rowsPerDay) * 86400LL + (row % rowsPerDay) * 86400LL / rowsPerDay;
+        facts.addLine(item.getId(), item.getName(), row % 3 + 1, toCents(item.getPrice()), placedAt,
+            row % 10 + 1, "W001", row % 4 == 0);
+    }
+
+    time_t now = time(0);
+    auto timeQuery = [](const char* label, auto query) {
+        auto start = std::chrono::steady_clock::now();
+        auto result = query();
+        auto end = std::chrono::steady_clock::now();
+        std::cout << std::left << std::setw(34) << label
+            << std::chrono::duration_cast<std::chrono::microseconds>(end - start).count() / 1000.0 << " ms" << std::endl;
+        return result;
+    };
+
+    std::cout << "Order-line store benchmark: " << facts.rowCount() << " lines over " << DAYS << " days" << std::endl;
+    auto today = timeQuery("Sales for today:", [&]() { return facts.salesBetween(startOfDay(now), startOfDay(now, 1)); });
+    auto year = timeQuery("Sales for the year:", [&]() { return facts.salesBetween(yearStart, startOfDay(now, 1)); });
+    timeQuery("Item quantities for the year:", [&]() { return facts.quantityByItem(yearStart, startOfDay(now, 1)); });
+
+    std::cout << "Today: " << today.orderCount << " orders, $" << std::fixed << std::setprecision(2) << today.subtotalCents / 100.0 << std::endl;
+    std::cout << "Year: " << year.orderCount << " orders, $" << year.subtotalCents / 100.0 << std::endl;
+    return 0;
+}
+
+// Schedules timerCount timers up to a day out on a one-second wheel,
+// cancels every other one and runs the wheel through to the end
+int runTimerBenchmark(int timerCount) {
+    TwoCli::TimerWheel<int> wheel;
+    std::vector<TwoCli::TimerHandle> handles;
+    handles.reserve(timerCount);
+    unsigned long long state = 12345;
+
+    auto started = std::chrono::steady_clock::now();
+    for (int i = 0; i < timerCount; ++i) {
+        state = state * 6364136223846793005ULL + 1442695040888963407ULL;
+        handles.push_back(wheel.schedule(1 + (state >> 33) % 86400, i));
+    }
+    auto scheduled = std::chrono::steady_clock::now();
+    for (int i = 0; i < timerCount; i += 2) {
+        wheel.cancel(handles[i]);
+    }
+    auto cancelled = std::chrono::steady_clock::now();
+    std::vector<int> fired;
+    wheel.advanceTo(86400, fired);
+    auto finished = std::chrono::steady_clock::now();
+
+    auto nanosPer = [](std::chrono::steady_clock::duration elapsed, int count) {
+        return std::chrono::duration<double, std::nano>(elapsed).count() / std::max(1, count);
+    };
+    std::cout << "Timer wheel benchmark: " << timerCount << " timers over one day of one-second ticks" << std::endl;
+    std::cout << std::fixed << std::setprecision(1);
+    std::cout << "Schedule: " << nanosPer(scheduled - started, timerCount) << " ns per timer" << std::endl;
+    std::cout << "Cancel:   " << nanosPer(cancelled - scheduled, (timerCount + 1) / 2) << " ns per timer" << std::endl;
+    std::cout << "Advance:  " << std::chrono::duration<double, std::milli>(finished - cancelled).count() << " ms for 86400 ticks, "
+        << fired.size() << " fired, " << wheel.pending() << " still pending" << std::endl;
+    return fired.size() == static_cast<size_t>(timerCount / 2) ? 0 : 1;
+}
+
+// Bounded queue behind one mutex, as the baseline for the lock-free one
+template<typename T>
+class MutexQueue {
+private:
+    std::mutex queueMutex;
+    std::vector<T> ring;
+    size_t head = 0;
+    size_t count = 0;
+
+public:
+    explicit MutexQueue(size_t capacity) : ring(capacity) {}
+
+    bool tryPush(const T& value) {
+        std::lock_guard<std::mutex> lock(queueMutex);
+        if (count == ring.size()) {
+            return false;
+        }
+        ring[(head + count++) % ring.size()] = value;
+        return true;
+    }
+
+    bool tryPop(T& out) {
+        std::lock_guard<std::mutex> lock(queueMutex);
+        if (count == 0) {
+            return false;
+        }
+        out = ring[head];
+        head = (head + 1) % ring.size();
+        count--;
+        return true;
+    }
+};
+
+// 'threads' producers each push 'perProducer' ids while 'threads' consumers
+// pop them; returns millions of items per second, or -1 if any went missing
+template<typename Queue>
+double measureQueueThroughput(int threads, long long perProducer) {
+    Queue queue(1024);
+    std::atomic<long long> consumed(0);
+    std::atomic<unsigned long long> checksum(0);
+    long long total = perProducer * threads;
+
+    auto started = std::chrono::steady_clock::now();
+    std::vector<std::thread> workers;
+    for (int p = 0; p < threads; ++p) {
+        workers.emplace_back([&queue, p, perProducer]() {
+            for (long long i = 1; i <= perProducer; ++i) {
+                OrderId id = OrderId::make(static_cast<unsigned>(p), static_cast<unsigned long long>(i));
+                while (!queue.tryPush(id)) {
+                    std::this_thread::yield();
+                }
+            }
+        });
+    }
+    for (int c = 0; c < threads; ++c) {
+        workers.emplace_back([&queue, &consumed, &checksum, total]() {
+            unsigned long long localSum = 0;
+            OrderId id;
+            while (consumed.load(std::memory_order_relaxed) < total) {
+                if (queue.tryPop(id)) {
+                    localSum += id.getValue();
+                    consumed.fetch_add(1, std::memory_order_relaxed);
+                }
+                else {
+                    std::this_thread::yield();
+                }
+            }
+            checksum.fetch_add(localSum);
+        });
+    }
+    for (auto& worker : workers) {
+        worker.join();
+    }
+    double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - started).count();
+
+    unsigned long long expected = 0;
+    for (int p = 0; p < threads; ++p) {
+        for (long long i = 1; i <= perProducer; ++i) {
+            expected += OrderId::make(static_cast<unsigned>(p), static_cast<unsigned long long>(i)).getValue();
+        }
+    }
+    if (consumed.load() != total || checksum.load() != expected) {
+        return -1.0;
+    }
+    return total / seconds / 1e6;
+}
+
+// Kitchen handoff contention: lock-free queue against a mutex queue with
+// 1, 4 and 16 producer/consumer pairs
+int runQueueBenchmark(long long itemCount) {
+    std::cout << "Kitchen queue benchmark: " << itemCount << " order ids per run" << std::endl;
+    std::cout << std::left << std::setw(10) << "Threads" << std::setw(18) << "Lock-free Mops/s" << "Mutex Mops/s" << std::endl;
+    int status = 0;
+    for (int threads : { 1, 4, 16 }) {
+        long long perProducer = std::max(1LL, itemCount / threads);
+        double lockFree = measureQueueThroughput<TwoCli::MpmcQueue<OrderId>>(threads, perProducer);
+        double locked = measureQueueThroughput<MutexQueue<OrderId>>(threads, perProducer);
+        if (lockFree < 0 || locked < 0) {
+            status = 1;
+        }
+        std::cout << std::left << std::setw(10) << (std::to_string(threads) + "+" + std::to_string(threads))
+            << std::fixed << std::setprecision(2) << std::setw(18) << lockFree << locked << std::endl;
+    }
+    if (status != 0) {
+        std::cout << "Lost or duplicated items detected!" << std::endl;
+    }
+    return status;
+}
+
+// Kitchen display fed from the shared-memory ticket ring. Shows each ticket
+// as it arrives and how long it took to get here; waits for the terminal to
+// appear and carries on if it restarts. Runs until Enter, or for 'seconds'.
+int runKitchenDisplay(int seconds) {
+    std::unique_ptr<KitchenTicketRing> ring;
+    bool announced = false;
+    auto started = std::chrono::steady_clock::now();
+    auto timeUp = [&]() {
+        return seconds > 0 && std::chrono::steady_clock::now() - started >= std::chrono::seconds(seconds);
+    };
+    while (!(ring = std::unique_ptr<KitchenTicketRing>(new KitchenTicketRing(KITCHEN_RING_NAME, false)))->isOpen()) {
+        if (!announced) {
+            std::cout << "Waiting for a terminal started with --kitchen-feed..." << std::endl;
+            announced = true;
+        }
+        if (timeUp() || (_kbhit() && _getch())) {
+            return 1;
+        }
+        std::this_thread::sleep_for(std::chrono::milliseconds(500));
+    }
+
+    std::cout << "===== KITCHEN DISPLAY =====" << std::endl;
+    std::cout << "(Press Enter to exit)" << std::endl;
+    std::vector<SharedKitchenTicket> tickets;
+    std::vector<uint64_t> sequences;
+    tickets.reserve(64);
+    sequences.reserve(64);
+    uint64_t reportedRestarts = 0, reportedLost = 0, shown = 0, timed = 0;
+    long long totalLatency = 0;
+    long long openedAt = wallClockMicros(); // Tickets from before this were already waiting
+    int idlePolls = 0;
+    while (!timeUp()) {
+        tickets.clear();
+        sequences.clear();
+        if (ring->poll(tickets, 64, &sequences) == 0) {
+            // Spin briefly so a new ticket shows within microseconds, then back
+            // off to sleeping until the next ticket arrives
+            if (idlePolls < 2000) {
+                ++idlePolls;
+                std::this_thread::yield();
+                continue;
+            }
+            if (_kbhit()) {
+                char ch = _getch();
+                if (ch == '\r' || ch == '\n') {
+                    break;
+                }
+            }
+            std::this_thread::sleep_for(std::chrono::microseconds(200));
+            continue;
+        }
+        idlePolls = 0;
+
+        long long now = wallClockMicros();
+        if (ring->getRestarts() != reportedRestarts) {
+            reportedRestarts = ring->getRestarts();
+            std::cout << "*** Terminal restarted; continuing from ticket " << sequences.front() << " ***" << std::endl;
+        }
+        if (ring->getLost() != reportedLost) {
+            std::cout << "*** Missed " << ring->getLost() - reportedLost << " tickets while behind ***" << std::endl;
+            reportedLost = ring->getLost();
+        }
+        for (size_t i = 0; i < tickets.size(); ++i) {
+            const SharedKitchenTicket& ticket = tickets[i];
+            shown++;
+            std::cout << "#" << std::left << std::setw(6) << sequences[i] << std::setw(8) << OrderId(ticket.orderId).toString()
+                << "Table " << std::setw(4) << ticket.tableNumber << std::setw(13)
+                << orderStatusToString(static_cast<OrderStatus>(ticket.status)) << ticket.items;
+            if (ticket.publishedAtMicros >= openedAt) {
+                long long latency = now - ticket.publishedAtMicros;
+                totalLatency += latency;
+                timed++;
+                std::cout << "  (+" << latency << " us)";
+            }
+            std::cout << std::endl;
+        }
+    }
+
+    std::cout << "Kitchen display closed after " << shown << " tickets";
+    if (timed > 0) {
+        std::cout << ", average delivery " << totalLatency / static_cast<long long>(timed) << " us";
+    }
+    std::cout << "." << std::endl;
+    return 0;
+}
+
+std::string defaultKitchenSocketPath() {
+    return (std::filesystem::temp_directory_path() / "eats_kitchen.sock").string();
+}
+
+// Headless kitchen screen fed by a terminal started with --kitchen-server.
+// Prints each ticket as it is pushed; if the terminal goes away it keeps
+// retrying and resumes from the first ticket it missed. Runs until Enter,
+// or for 'seconds'.
+int runKitchenClient(const std::string& socketPath, int seconds) {
+    TwoCli::LineStreamClient client(socketPath);
+    auto started = std::chrono::steady_clock::now();
+    bool waitingShown = false;
+    long long received = 0;
+    while (seconds <= 0 || std::chrono::steady_clock::now() - started < std::chrono::seconds(seconds)) {
+        if (_kbhit()) {
+            char ch = _getch();
+            if (ch == '\r' || ch == '\n') {
+                break;
+            }
+        }
+        if (!client.isConnected()) {
+            if (!client.connect()) {
+                if (!waitingShown) {
+                    std::cout << "Waiting for a terminal started with --kitchen-server on " << socketPath << "..." << std::endl;
+                    waitingShown = true;
+                }
+                std::this_thread::sleep_for(std::chrono::milliseconds(500));
+                continue;
+            }
+            std::cout << "Connected; " << (client.getNextSequence() == 0 ? "starting from the oldest kept ticket"
+                : "resuming from ticket " + std::to_string(client.getNextSequence())) << "." << std::endl;
+            waitingShown = false;
+        }
+
+        bool alive = client.receive([&received](const std::string& line) {
+            if (line.compare(0, 7, "{\"gap\":") == 0) {
+                std::cout << "*** Tickets " << jsonField(line, "from") << " to " << jsonField(line, "to")
+                    << " are no longer kept; continuing after them ***" << std::endl;
+                return;
+            }
+            if (line.compare(0, 9, "{\"reset\":") == 0) {
+                std::cout << "*** Terminal restarted; starting over from its ticket " << jsonField(line, "next") << " ***" << std::endl;
+                return;
+            }
+            received++;
+            long long sentAt = std::atoll(jsonField(line, "sentAtMicros").c_str());
+            std::cout << "#" << std::left << std::setw(6) << jsonField(line, "seq") << std::setw(8) << jsonField(line, "order")
+                << "Table " << std::setw(4) << jsonField(line, "table") << std::setw(13) << jsonField(line, "status")
+                << jsonField(line, "items") << "  (+" << wallClockMicros() - sentAt << " us)" << std::endl;
+            }, 200);
+        if (!alive) {
+            std::cout << "*** Connection lost; will resume from ticket " << client.getNextSequence() << " ***" << std::endl;
+        }
+    }
+    std::cout << "Kitchen client closed after " << received << " tickets." << std::endl;
+    return 0;
+}
+
+// Background pool benchmark: small tasks at mixed priorities, each with a
+// continuation, submitted from outside the pool and fanned out from inside it
+// (so idle workers have to steal). Every result must arrive exactly once.
+int runPoolBenchmark(int taskCount) {
+    TwoCli::WorkStealingPool pool;
+    std::atomic<long long> sum(0);
+    auto work = [](int value) {
+        long long acc = value;
+        for (int step = 0; step < 200; ++step) {
+            acc = (acc * 31 + step) % 1000003;
+        }
+        return acc;
+    };
+
+    auto started = std::chrono::steady_clock::now();
+    std::vector<TwoCli::TaskFuture<void>> done;
+    done.reserve(taskCount / 2 + 1);
+    for (int i = 0; i < taskCount / 2; ++i) {
+        TwoCli::TaskPriority priority = static_cast<TwoCli::TaskPriority>(i % TwoCli::TASK_PRIORITY_COUNT);
+        done.push_back(pool.submit([i, &work]() { return work(i); }, priority)
+            .then([&sum](long long value) { sum += value; }, priority));
+    }
+
+    // The other half is spawned by one task, landing on a single worker's queue
+    int fanned = taskCount - taskCount / 2;
+    TwoCli::TaskFuture<void> fanOut = pool.submit([&pool, &sum, &work, fanned, offset = taskCount / 2]() {
+        std::vector<TwoCli::TaskFuture<void>> children;
+        children.reserve(fanned);
+        for (int i = 0; i < fanned; ++i) {
+            children.push_back(pool.submit([i, offset, &sum, &work]() { sum += work(offset + i); }));
+        }
+        for (const auto& child : children) {
+            child.wait();
+        }
+        });
+    for (const auto& future : done) {
+        future.wait();
+    }
+    fanOut.wait();
+    double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - started).count();
+
+    long long expected = 0;
+    for (int i = 0; i < taskCount; ++i) {
+        expected += work(i);
+    }
+
+    TwoCli::WorkStealingPool::Stats stats = pool.stats();
+    std::cout << "Pool benchmark: " << taskCount << " tasks on " << stats.workers << " workers in "
+        << std::fixed << std::setprecision(3) << seconds << " s ("
+        << std::setprecision(0) << taskCount / std::max(seconds, 1e-9) << " tasks/s)" << std::endl;
+    std::cout << "Stolen: " << stats.stolen << ", most queued at once: " << stats.peakQueued << std::endl;
+    for (int priority = 0; priority < TwoCli::TASK_PRIORITY_COUNT; ++priority) {
+        const TwoCli::WorkStealingPool::PriorityStats& row = stats.byPriority[priority];
+        std::cout << std::left << std::setw(8) << TwoCli::taskPriorityToString(static_cast<TwoCli::TaskPriority>(priority))
+            << row.executed << " tasks, wait avg " << std::setprecision(1) << row.averageWaitMicros
+            << " us / max " << row.maxWaitMicros << " us, run avg " << row.averageRunMicros << " us" << std::endl;
+    }
+    bool correct = sum.load() == expected;
+    std::cout << "Results: " << (correct ? "all accounted for" : "MISMATCH") << std::endl;
+    return correct ? 0 : 1;
+}
+
+// A sitting that runs past a calendar block's end (UTC midnight) must hold the next block's first slots
+int runCalendarCheck() {
+    std::vector<Table> tables = { Table(1, 4) };
+    ReservationCalendar calendar(tables);
+    time_t midnight = (time(0) / 86400 + 2) * 86400; // A UTC midnight in the future
+    bool firstBooked = calendar.book(1, midnight - 3600, "late");
+    bool overlapRefused = !calendar.book(1, midnight, "early") && !calendar.isTableFree(1, midnight);
+    bool laterFree = calendar.isTableFree(1, midnight + 30 * 60, 60);
+    bool correct = firstBooked && overlapRefused && laterFree;
+    std::cout << "Calendar: booking across midnight UTC blocks the next day's first slots"
+        << (correct ? "  OK" : "  FAILED") << std::endl;
+    return correct ? 0 : 1;
+}
+
+// Many terminals entering, cooking, serving and settling orders at once on
+// a shared system in a scratch directory, while a manager terminal keeps
+// changing a price. Afterwards every placed order must be billed exactly
+// once and the sales records must add up to what the terminals placed.
+int runStressTest(int terminalCount, int ordersPerTerminal) {
+    std::filesystem::path scratch = std::filesystem::temp_directory_path() /
+        ("eats_stress_" + std::to_string(static_cast<long long>(time(0))) + "_" + std::to_string(std::rand()));
+    std::filesystem::create_directories(scratch);
+    int status = 0;
+    {
+        RestaurantSystem system("Stress Test", 0, true, scratch.string() + "/");
+        const char* itemIds[] = { "A001", "A002", "M001", "M002", "D001", "D002", "B001" };
+        const int TABLE_COUNT = 10;
+
+        std::atomic<long long> placedOrders(0), placedCents(0), settledCents(0), rejected(0), doubleServes(0);
+        std::atomic<bool> entryDone(false);
+
+        auto started = std::chrono::steady_clock::now();
+        std::vector<std::thread> terminals;
+        for (int t = 0; t < terminalCount; ++t) {
+            terminals.emplace_back([&, t]() {
+                TerminalSession session(system, "W" + std::to_string(t));
+                int tableNumber = t % TABLE_COUNT + 1;
+                for (int k = 0; k < ordersPerTerminal; ++k) {
+                    std::vector<OrderLineRequest> lines = {
+                        { itemIds[(t + k) % 7], 1 + k % 3, "" },
+                        { itemIds[(t * 3 + k) % 7], 1, k % 5 == 0 ? "extra spicy" : "" }
+                    };
+
+                    // Someone else may settle and free the table in between; reseat and retry
+                    OrderId orderId;
+                    long long cents = 0;
+                    OpResult placed;
+                    while ((placed = session.placeOrder(tableNumber, lines, &orderId, &cents)) == OpResult::TableNotOccupied) {
+                        session.seat(tableNumber, 2);
+                    }
+                    if (placed != OpResult::Ok) {
+                        rejected++;
+                        continue;
+                    }
+                    placedOrders++;
+                    placedCents += cents;
+
+                    session.startCooking(orderId);
+                    session.markReady(orderId);
+                    // Fails harmlessly if another terminal billed the table first
+                    if (session.serve(orderId) != OpResult::Ok) {
+                        rejected++;
+                    }
+                    // A repeated serve must always be refused
+                    if (k % 8 == 5 && session.serve(orderId) == OpResult::Ok) {
+                        doubleServes++;
+                    }
+
+                    long long billed = 0;
+                    if (k % 4 == 3 && session.settle(tableNumber, &billed) == OpResult::Ok) {
+                        settledCents += billed;
+                    }
+                }
+            });
+        }
+
+        std::thread manager([&]() {
+            int round = 0;
+            while (!entryDone.load()) {
+                system.setMenuItemPrice("B001", (round++ % 2 == 0) ? 5.49 : 4.99);
+                std::this_thread::yield();
+            }
+        });
+
+        for (auto& terminal : terminals) {
+            terminal.join();
+        }
+        entryDone = true;
+        manager.join();
+
+        // Bill whatever is still open
+        for (int tableNumber : system.occupiedTableNumbers()) {
+            long long billed = 0;
+            if (system.settleTable(tableNumber, nullptr, &billed) == OpResult::Ok) {
+                settledCents += billed;
+            }
+        }
+        double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - started).count();
+
+        OrderLineFacts::SalesTotals sales = system.completedSales();
+        long long expectedOrders = static_cast<long long>(terminalCount) * ordersPerTerminal;
+        bool allPlaced = placedOrders.load() == expectedOrders;
+        bool allBilled = sales.orderCount == placedOrders.load() && system.openOrderCount() == 0;
+        bool centsMatch = sales.subtotalCents == placedCents.load() && settledCents.load() == placedCents.load();
+        bool dailyMatches = system.completedToday() == placedOrders.load();
+        bool noDoubleServes = doubleServes.load() == 0;
+
+        // Every event must reach the audit log exactly once
+        system.flushEvents();
+        long long auditLines = 0;
+        {
+            std::ifstream audit(scratch / "audit_log.txt");
+            std::string line;
+            while (std::getline(audit, line)) {
+                auditLines++;
+            }
+        }
+        bool eventsMatch = system.eventsDelivered() == system.eventsPublished()
+            && auditLines == static_cast<long long>(system.eventsPublished());
+
+        std::cout << "Stress test: " << terminalCount << " terminals x " << ordersPerTerminal << " orders in "
+            << std::fixed << std::setprecision(2) << seconds << " s ("
+            << std::setprecision(0) << placedOrders.load() / std::max(seconds, 1e-9) << " orders/s)" << std::endl;
+        std::cout << "Placed: " << placedOrders.load() << " / " << expectedOrders << (allPlaced ? "  OK" : "  FAILED") << std::endl;
+        std::cout << "Billed: " << sales.orderCount << ", still open: " << system.openOrderCount() << (allBilled ? "  OK" : "  FAILED") << std::endl;
+        std::cout << std::setprecision(2) << "Sales: $" << sales.subtotalCents / 100.0 << " recorded, $" << settledCents.load() / 100.0
+            << " billed, $" << placedCents.load() / 100.0 << " placed" << (centsMatch ? "  OK" : "  FAILED") << std::endl;
+        std::cout << "Daily totals: " << system.completedToday() << " orders" << (dailyMatches ? "  OK" : "  FAILED") << std::endl;
+        std::cout << "Menu versions published: " << system.getMenuVersion() - 1
+            << ", serves lost to an earlier bill: " << rejected.load() << std::endl;
+        std::cout << "Refused status changes: " << system.rejectedStatusChanges() << ", repeated serves accepted: "
+            << doubleServes.load() << (noDoubleServes ? "  OK" : "  FAILED") << std::endl;
+        std::cout << "Events: " << system.eventsPublished() << " published in " << system.eventBatches() << " batches, "
+            << auditLines << " audited" << (eventsMatch ? "  OK" : "  FAILED") << std::endl;
+
+        status = (allPlaced && allBilled && centsMatch && dailyMatches && noDoubleServes && eventsMatch) ? 0 : 1;
+    }
+    std::filesystem::remove_all(scratch);
+    return status;
+}
+
 // Main function
-int main() {
-    RestaurantSystem restaurantSystem("Eats & Treats");
+int main(int argc, char* argv[]) {
+    // Each front-of-house terminal gets its own number so ids never collide
+    unsigned terminalId = 0;
+    bool useShiftArena = false;
+    bool kitchenFeed = false;
+    std::string kitchenSocket; // Serve kitchen clients on this socket if set
+    std::string recordPath;    // Append each operation to this script if set
+    for (int i = 1; i < argc; ++i) {
+        std::string arg = argv[i];
+        if (arg == "--bench-alloc") {
+            std::string mode = (i + 1 < argc) ? argv[i + 1] : "";
+            int orderCount = (i + 2 < argc) ? std::atoi(argv[i + 2]) : 100000;
+            return runAllocationBenchmark(mode, orderCount > 0 ? orderCount : 100000);
+        }
+        else if (arg == "--bench-facts") {
+            int rowCount = (i + 1 < argc) ? std::atoi(argv[i + 1]) : 0;
+            return runFactStoreBenchmark(rowCount > 0 ? rowCount : 2000000);
+        }
+        else if (arg == "--bench-timers") {
+            int timerCount = (i + 1 < argc) ? std::atoi(argv[i + 1]) : 0;
+            return runTimerBenchmark(timerCount > 0 ? timerCount : 100000);
+        }
+        else if (arg == "--bench-mpmc") {
+            long long itemCount = (i + 1 < argc) ? std::atoll(argv[i + 1]) : 0;
+            return runQueueBenchmark(itemCount > 0 ? itemCount : 2000000);
+        }
+        else if (arg == "--bench-pool") {
+            int taskCount = (i + 1 < argc) ? std::atoi(argv[i + 1]) : 0;
+            return runPoolBenchmark(taskCount > 0 ? taskCount : 200000);
+        }
+        else if (arg == "--stress") {
+            int terminalCount = (i + 1 < argc) ? std::atoi(argv[i + 1]) : 0;
+            int ordersPerTerminal = (i + 2 < argc) ? std::atoi(argv[i + 2]) : 0;
+            return runStressTest(terminalCount > 0 ? terminalCount : 16, ordersPerTerminal > 0 ? ordersPerTerminal : 2000);
+        }
+        else if (arg == "--check-calendar") {
+            return runCalendarCheck();
+        }
+        else if (arg == "--script" && i + 1 < argc) {
+            return runScript(argv[i + 1]);
+        }
+        else if (arg == "--record-script" && i + 1 < argc) {
+            recordPath = argv[++i];
+        }
+        else if (arg == "--kitchen-display") {
+            int seconds = (i + 1 < argc) ? std::atoi(argv[i + 1]) : 0;
+            return runKitchenDisplay(seconds);
+        }
+        else if (arg == "--kitchen-feed") {
+            kitchenFeed = true;
+        }
+        else if (arg == "--kitchen-server") {
+            kitchenSocket = (i + 1 < argc && argv[i + 1][0] != '-') ? argv[++i] : defaultKitchenSocketPath();
+        }
+        else if (arg == "--kitchen-client") {
+            bool hasPath = i + 1 < argc && argv[i + 1][0] != '-' && !std::isdigit(static_cast<unsigned char>(argv[i + 1][0]));
+            std::string socketPath = hasPath ? argv[++i] : defaultKitchenSocketPath();
+            int seconds = (i + 1 < argc) ? std::atoi(argv[i + 1]) : 0;
+            return runKitchenClient(socketPath, seconds);
+        }
+        else if (arg == "--shift-arena") {
+            useShiftArena = true;
+        }
+        else if (arg == "--terminal" && i + 1 < argc) {
+            unsigned long value = std::strtoul(argv[++i], nullptr, 10);
+            if (value > OrderId::MAX_TERMINAL) {
+                std::cerr << "Terminal number must be between 0 and " << OrderId::MAX_TERMINAL << std::endl;
+                return 1;
+            }
+            terminalId = static_cast<unsigned>(value);
+        }
+    }
+
+    RestaurantSystem restaurantSystem("Eats & Treats", terminalId, useShiftArena);
+    if (kitchenFeed && !restaurantSystem.enableKitchenFeed()) {
+        std::cerr << "Could not open the shared kitchen ticket ring (is another terminal already feeding it?); kitchen displays will not update." << std::endl;
+    }
+    if (!kitchenSocket.empty() && !restaurantSystem.enableKitchenServer(kitchenSocket)) {
+        std::cerr << "Could not start the kitchen server on " << kitchenSocket << " (is another terminal already serving it?); kitchen clients will not update." << std::endl;
+    }
+    if (!recordPath.empty() && !restaurantSystem.recordScript(recordPath)) {
+        std::cerr << "Could not open " << recordPath << " to record the shift." << std::endl;
+    }
     restaurantSystem.run();
     return 0;
 }
\ No newline at end of file
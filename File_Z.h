@@ -9,108 +9,1927 @@
 #include <thread>
 #include <ctime>
 #include <mutex>
+#include <condition_variable>
+#include <cstdint>
+#include <atomic>
+#include <memory>
+#include <deque>
+#include <optional>
+#include <exception>
+#include <type_traits>
+#include <utility>
 #include <sstream>
 #include <functional>
+#include <unordered_map>
 #include <conio.h>
 #include <limits>
+#include <cstring>
+#include <filesystem>
+
+#ifdef _WIN32
+#ifndef NOMINMAX
+#define NOMINMAX
+#endif
+#include <windows.h>
+#else
+#include <fcntl.h>
+#include <sys/file.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+#ifdef __linux__
+#include <cerrno>
+#include <poll.h>
+#include <sys/epoll.h>
+#include <sys/eventfd.h>
+#include <sys/socket.h>
+#include <sys/un.h>
+#endif
 
 using namespace std;
 
-namespace TwoCli {
+namespace TwoCli {
+
+    // Base class for records (renamed for clarity)
+    class stbase {
+    public:
+        virtual ~stbase() = default; // Default destructor for proper cleanup
+        virtual string toString() const = 0; // Pure virtual function for string conversion
+
+        // Get current timestamp
+        static string getCurrentTimeMark() {
+            auto nowTime = chrono::system_clock::now();
+            time_t currentTime = chrono::system_clock::to_time_t(nowTime);
+
+            char buffer[26]; // Need 26 chars for proper date/time format
+
+#ifdef _WIN32
+            ctime_s(buffer, sizeof(buffer), &currentTime);
+#else
+            ctime_r(&currentTime, buffer);
+#endif
+
+            string timestamp(buffer);
+            if (!timestamp.empty() && timestamp[timestamp.length() - 1] == '\n') {
+                timestamp.pop_back(); // Remove newline character
+            }
+            return timestamp;
+        }
+    };
+
+    // Fixed-capacity ring buffer; once full, each push overwrites the oldest entry
+    template<typename T>
+    class RingBuffer {
+    private:
+        vector<T> slots;
+        size_t head;   // Next slot to write
+        size_t count;
+
+    public:
+        explicit RingBuffer(size_t capacity) : slots(capacity), head(0), count(0) {}
+
+        void push(const T& value) {
+            slots[head] = value;
+            head = (head + 1) % slots.size();
+            if (count < slots.size()) {
+                count++;
+            }
+        }
+
+        // 0 is the oldest entry, size() - 1 the newest
+        const T& at(size_t index) const { return slots[(head + slots.size() - count + index) % slots.size()]; }
+        T& newest() { return slots[(head + slots.size() - 1) % slots.size()]; }
+        const T& newest() const { return slots[(head + slots.size() - 1) % slots.size()]; }
+
+        size_t size() const { return count; }
+        size_t capacity() const { return slots.size(); }
+        bool empty() const { return count == 0; }
+        void clear() { head = 0; count = 0; }
+    };
+
+    // Handle to a scheduled timer; stale once the timer fires or is cancelled
+    struct TimerHandle {
+        uint32_t index = UINT32_MAX;
+        uint32_t generation = 0;
+
+        bool isSet() const { return index != UINT32_MAX; }
+    };
+
+    // Hierarchical timer wheel: 4 levels of 64 slots, each level 64 times
+    // coarser than the one below, so with one-second ticks it spans about
+    // 194 days. Timers live in a slab of nodes linked into their slot, which
+    // makes schedule and cancel O(1) with no allocation once the slab has
+    // grown. Generation counters make handles to freed nodes harmless.
+    // Not thread-safe on its own; see TimerService.
+    template<typename Payload>
+    class TimerWheel {
+    private:
+        static const int LEVELS = 4;
+        static const int SLOT_BITS = 6;
+        static const int SLOTS = 1 << SLOT_BITS;
+        static const uint32_t NONE = UINT32_MAX;
+
+        struct Node {
+            uint64_t expires;
+            Payload payload;
+            uint32_t prev;
+            uint32_t next;
+            uint32_t bucket;     // Slot list the node is in, NONE when free
+            uint32_t generation;
+        };
+
+        vector<Node> nodes;
+        uint32_t freeList;
+        uint32_t heads[LEVELS * SLOTS];
+        uint64_t currentTick;
+        size_t pendingCount;
+
+        void link(uint32_t index) {
+            Node& node = nodes[index];
+            uint64_t delta = node.expires > currentTick ? node.expires - currentTick : 0;
+            int level = 0;
+            while (level < LEVELS - 1 && delta >= (uint64_t(1) << (SLOT_BITS * (level + 1)))) {
+                level++;
+            }
+            // Past the top level's reach: park in the furthest top slot and re-place on cascade
+            uint64_t target = node.expires;
+            uint64_t reach = uint64_t(1) << (SLOT_BITS * LEVELS);
+            if (delta >= reach) {
+                target = currentTick + reach - 1;
+            }
+            uint32_t bucket = static_cast<uint32_t>(level * SLOTS + ((target >> (SLOT_BITS * level)) & (SLOTS - 1)));
+
+            node.bucket = bucket;
+            node.prev = NONE;
+            node.next = heads[bucket];
+            if (node.next != NONE) {
+                nodes[node.next].prev = index;
+            }
+            heads[bucket] = index;
+        }
+
+        void unlink(uint32_t index) {
+            Node& node = nodes[index];
+            if (node.prev != NONE) {
+                nodes[node.prev].next = node.next;
+            }
+            else {
+                heads[node.bucket] = node.next;
+            }
+            if (node.next != NONE) {
+                nodes[node.next].prev = node.prev;
+            }
+            node.bucket = NONE;
+        }
+
+        void release(uint32_t index) {
+            nodes[index].generation++;
+            nodes[index].next = freeList;
+            freeList = index;
+            pendingCount--;
+        }
+
+        // Move every timer in a slot down to the level it now belongs in
+        void cascade(uint32_t bucket) {
+            uint32_t index = heads[bucket];
+            heads[bucket] = NONE;
+            while (index != NONE) {
+                uint32_t next = nodes[index].next;
+                link(index);
+                index = next;
+            }
+        }
+
+    public:
+        TimerWheel() : freeList(NONE), currentTick(0), pendingCount(0) {
+            for (uint32_t& head : heads) {
+                head = NONE;
+            }
+        }
+
+        // Fire 'delayTicks' ticks from now (at least one)
+        TimerHandle schedule(uint64_t delayTicks, const Payload& payload) {
+            uint32_t index;
+            if (freeList != NONE) {
+                index = freeList;
+                freeList = nodes[index].next;
+            }
+            else {
+                index = static_cast<uint32_t>(nodes.size());
+                nodes.push_back(Node());
+                nodes[index].generation = 0;
+            }
+            Node& node = nodes[index];
+            node.expires = currentTick + (delayTicks > 0 ? delayTicks : 1);
+            node.payload = payload;
+            link(index);
+            pendingCount++;
+
+            TimerHandle handle;
+            handle.index = index;
+            handle.generation = node.generation;
+            return handle;
+        }
+
+        // Returns false if the timer already fired or was cancelled
+        bool cancel(TimerHandle handle) {
+            if (!handle.isSet() || handle.index >= nodes.size()) {
+                return false;
+            }
+            Node& node = nodes[handle.index];
+            if (node.generation != handle.generation || node.bucket == NONE) {
+                return false;
+            }
+            unlink(handle.index);
+            release(handle.index);
+            return true;
+        }
+
+        // Advance to 'tick', appending the payloads of timers that came due
+        void advanceTo(uint64_t tick, vector<Payload>& fired) {
+            while (currentTick < tick) {
+                currentTick++;
+
+                // Higher levels first, so their timers can drop all the way down this tick
+                for (int level = LEVELS - 1; level > 0; --level) {
+                    if ((currentTick & ((uint64_t(1) << (SLOT_BITS * level)) - 1)) == 0) {
+                        cascade(static_cast<uint32_t>(level * SLOTS + ((currentTick >> (SLOT_BITS * level)) & (SLOTS - 1))));
+                    }
+                }
+
+                uint32_t bucket = static_cast<uint32_t>(currentTick & (SLOTS - 1));
+                uint32_t index = heads[bucket];
+                while (index != NONE) {
+                    uint32_t next = nodes[index].next;
+                    if (nodes[index].expires <= currentTick) {
+                        unlink(index);
+                        fired.push_back(nodes[index].payload);
+                        release(index);
+                    }
+                    index = next;
+                }
+            }
+        }
+
+        uint64_t getTick() const { return currentTick; }
+        size_t pending() const { return pendingCount; }
+    };
+
+    // TimerWheel driven by its own thread. Due payloads are handed to the
+    // callback on that thread, outside the lock; schedule and cancel may be
+    // called from any thread.
+    template<typename Payload>
+    class TimerService {
+    private:
+        TimerWheel<Payload> wheel;
+        mutable mutex wheelMutex;
+        condition_variable wakeUp;
+        bool stopping;
+        chrono::milliseconds tickLength;
+        chrono::steady_clock::time_point started;
+        function<void(const Payload&)> onFire;
+        thread worker;
+
+        void runLoop() {
+            vector<Payload> fired;
+            unique_lock<mutex> lock(wheelMutex);
+            while (!stopping) {
+                wakeUp.wait_until(lock, started + tickLength * static_cast<long long>(wheel.getTick() + 1));
+                uint64_t due = static_cast<uint64_t>((chrono::steady_clock::now() - started) / tickLength);
+                wheel.advanceTo(due, fired);
+
+                if (!fired.empty()) {
+                    lock.unlock();
+                    for (const Payload& payload : fired) {
+                        onFire(payload);
+                    }
+                    fired.clear();
+                    lock.lock();
+                }
+            }
+        }
+
+    public:
+        TimerService(function<void(const Payload&)> onFire, chrono::milliseconds tickLength = chrono::milliseconds(1000))
+            : stopping(false), tickLength(tickLength), started(chrono::steady_clock::now()), onFire(onFire) {
+            worker = thread(&TimerService::runLoop, this);
+        }
+
+        ~TimerService() {
+            {
+                lock_guard<mutex> lock(wheelMutex);
+                stopping = true;
+            }
+            wakeUp.notify_one();
+            worker.join();
+        }
+
+        TimerService(const TimerService&) = delete;
+        TimerService& operator=(const TimerService&) = delete;
+
+        // Fire after 'delay', rounded up to whole ticks
+        TimerHandle schedule(chrono::milliseconds delay, const Payload& payload) {
+            lock_guard<mutex> lock(wheelMutex);
+            uint64_t ticks = static_cast<uint64_t>((delay + tickLength - chrono::milliseconds(1)) / tickLength);
+            return wheel.schedule(ticks, payload);
+        }
+
+        bool cancel(TimerHandle handle) {
+            lock_guard<mutex> lock(wheelMutex);
+            return wheel.cancel(handle);
+        }
+
+        size_t pending() const {
+            lock_guard<mutex> lock(wheelMutex);
+            return wheel.pending();
+        }
+    };
+
+    // Bounded multi-producer multi-consumer queue without locks (Dmitry
+    // Vyukov's design). Each cell carries a sequence number saying whose turn
+    // it is, so producers and consumers only contend on their own position
+    // counter with one CAS and never block each other. Capacity is rounded up
+    // to a power of two; tryPush fails when full and tryPop when empty.
+    template<typename T>
+    class MpmcQueue {
+    private:
+        struct Cell {
+            atomic<size_t> sequence;
+            T data;
+        };
+
+        static const size_t CACHE_LINE = 64;
+
+        unique_ptr<Cell[]> cells;
+        size_t mask;
+        alignas(CACHE_LINE) atomic<size_t> enqueuePos;
+        alignas(CACHE_LINE) atomic<size_t> dequeuePos;
+
+        static size_t roundUpToPowerOfTwo(size_t value) {
+            size_t power = 2;
+            while (power < value) {
+                power <<= 1;
+            }
+            return power;
+        }
+
+    public:
+        explicit MpmcQueue(size_t capacity)
+            : cells(new Cell[roundUpToPowerOfTwo(capacity)]), mask(roundUpToPowerOfTwo(capacity) - 1),
+            enqueuePos(0), dequeuePos(0) {
+            for (size_t i = 0; i <= mask; ++i) {
+                cells[i].sequence.store(i, memory_order_relaxed);
+            }
+        }
+
+        MpmcQueue(const MpmcQueue&) = delete;
+        MpmcQueue& operator=(const MpmcQueue&) = delete;
+
+        bool tryPush(const T& value) {
+            size_t pos = enqueuePos.load(memory_order_relaxed);
+            Cell* cell;
+            for (;;) {
+                cell = &cells[pos & mask];
+                size_t sequence = cell->sequence.load(memory_order_acquire);
+                intptr_t diff = static_cast<intptr_t>(sequence) - static_cast<intptr_t>(pos);
+                if (diff == 0) {
+                    if (enqueuePos.compare_exchange_weak(pos, pos + 1, memory_order_relaxed)) {
+                        break;
+                    }
+                }
+                else if (diff < 0) {
+                    return false; // Full
+                }
+                else {
+                    pos = enqueuePos.load(memory_order_relaxed);
+                }
+            }
+            cell->data = value;
+            cell->sequence.store(pos + 1, memory_order_release);
+            return true;
+        }
+
+        bool tryPop(T& out) {
+            size_t pos = dequeuePos.load(memory_order_relaxed);
+            Cell* cell;
+            for (;;) {
+                cell = &cells[pos & mask];
+                size_t sequence = cell->sequence.load(memory_order_acquire);
+                intptr_t diff = static_cast<intptr_t>(sequence) - static_cast<intptr_t>(pos + 1);
+                if (diff == 0) {
+                    if (dequeuePos.compare_exchange_weak(pos, pos + 1, memory_order_relaxed)) {
+                        break;
+                    }
+                }
+                else if (diff < 0) {
+                    return false; // Empty
+                }
+                else {
+                    pos = dequeuePos.load(memory_order_relaxed);
+                }
+            }
+            out = cell->data;
+            cell->sequence.store(pos + mask + 1, memory_order_release);
+            return true;
+        }
+
+        size_t capacity() const { return mask + 1; }
+
+        // Approximate while other threads are active
+        size_t sizeApprox() const {
+            size_t head = dequeuePos.load(memory_order_relaxed);
+            size_t tail = enqueuePos.load(memory_order_relaxed);
+            return tail > head ? tail - head : 0;
+        }
+    };
+
+    // Mailbox for handing messages from worker threads to the UI loop
+    template<typename T>
+    class ConcurrentInbox {
+    private:
+        mutable mutex inboxMutex;
+        vector<T> messages;
+
+    public:
+        void post(const T& message) {
+            lock_guard<mutex> lock(inboxMutex);
+            messages.push_back(message);
+        }
+
+        // Take everything posted so far, oldest first
+        vector<T> drain() {
+            vector<T> taken;
+            lock_guard<mutex> lock(inboxMutex);
+            taken.swap(messages);
+            return taken;
+        }
+    };
+
+    enum class TaskPriority { High, Normal, Low };
+    const int TASK_PRIORITY_COUNT = 3;
+
+    inline string taskPriorityToString(TaskPriority priority) {
+        switch (priority) {
+        case TaskPriority::High: return "High";
+        case TaskPriority::Normal: return "Normal";
+        case TaskPriority::Low: return "Low";
+        }
+        return "Unknown";
+    }
+
+    // Shared result slot between a running task and its TaskFuture
+    template<typename R>
+    class TaskState {
+    public:
+        typedef typename conditional<is_void<R>::value, bool, R>::type Stored;
+
+        // Run fn and publish its result or exception
+        template<typename F>
+        void run(F& fn) {
+            try {
+                if constexpr (is_void<R>::value) {
+                    fn();
+                    value.emplace(true);
+                }
+                else {
+                    value.emplace(fn());
+                }
+                settle(nullptr);
+            }
+            catch (...) {
+                settle(current_exception());
+            }
+        }
+
+        void fail(exception_ptr failure) {
+            settle(failure);
+        }
+
+        // Call continuation once the result is in (straight away if it already is)
+        void onReady(function<void()> continuation) {
+            unique_lock<mutex> lock(stateMutex);
+            if (!done) {
+                continuations.push_back(move(continuation));
+                return;
+            }
+            lock.unlock();
+            continuation();
+        }
+
+        bool isDone() {
+            lock_guard<mutex> lock(stateMutex);
+            return done;
+        }
+
+        void wait() {
+            unique_lock<mutex> lock(stateMutex);
+            ready.wait(lock, [this]() { return done; });
+        }
+
+        bool waitFor(chrono::milliseconds timeout) {
+            unique_lock<mutex> lock(stateMutex);
+            return ready.wait_for(lock, timeout, [this]() { return done; });
+        }
+
+        // Only valid once done
+        exception_ptr getError() const { return error; }
+        const Stored& getValue() const { return *value; }
+
+    private:
+        mutex stateMutex;
+        condition_variable ready;
+        bool done = false;
+        optional<Stored> value; // Written before done is set, read only after
+        exception_ptr error;
+        vector<function<void()>> continuations;
+
+        void settle(exception_ptr failure) {
+            vector<function<void()>> waiting;
+            {
+                lock_guard<mutex> lock(stateMutex);
+                error = failure;
+                done = true;
+                waiting.swap(continuations);
+            }
+            ready.notify_all();
+            for (auto& continuation : waiting) {
+                continuation();
+            }
+        }
+    };
+
+    template<typename R>
+    class TaskFuture;
+
+    // Fixed set of worker threads, each with its own queue per priority. A
+    // worker takes its newest task first (it is likely still in cache) and,
+    // when idle, steals the oldest task from another worker, always trying
+    // higher priorities first. Tasks posted from outside the pool are spread
+    // round-robin; tasks posted by a worker stay on that worker's queue.
+    // Each queue has its own small lock, so workers rarely contend.
+    // The destructor runs every queued task before the workers exit.
+    class WorkStealingPool {
+    public:
+        struct PriorityStats {
+            uint64_t executed;
+            double averageWaitMicros; // Queued until started
+            double maxWaitMicros;
+            double averageRunMicros;
+        };
+
+        struct Stats {
+            size_t workers;
+            size_t queued;     // Waiting right now
+            size_t peakQueued; // Most ever waiting at once
+            uint64_t stolen;
+            vector<size_t> depthByWorker;
+            PriorityStats byPriority[TASK_PRIORITY_COUNT];
+        };
+
+    private:
+        struct Job {
+            function<void()> run;
+            TaskPriority priority;
+            chrono::steady_clock::time_point queuedAt;
+        };
+
+        // Padded so neighbouring workers' queue locks never share a cache line
+        struct alignas(64) WorkerQueue {
+            mutex queueMutex;
+            deque<Job> jobs[TASK_PRIORITY_COUNT];
+            size_t depth = 0;
+        };
+
+        struct Timing {
+            atomic<uint64_t> executed{ 0 };
+            atomic<uint64_t> waitNanos{ 0 };
+            atomic<uint64_t> maxWaitNanos{ 0 };
+            atomic<uint64_t> runNanos{ 0 };
+        };
+
+        vector<unique_ptr<WorkerQueue>> queues;
+        vector<thread> workers;
+        mutex sleepMutex;
+        condition_variable wakeUp;
+        bool stopping;
+        atomic<size_t> queued;
+        atomic<size_t> peakQueued;
+        atomic<size_t> nextQueue;
+        atomic<uint64_t> stolen;
+        Timing timings[TASK_PRIORITY_COUNT];
+
+        // The pool and queue index of the calling thread, if it is a worker
+        static pair<const WorkStealingPool*, size_t>& currentWorker() {
+            static thread_local pair<const WorkStealingPool*, size_t> worker(nullptr, 0);
+            return worker;
+        }
+
+        bool takeFrom(size_t index, int priority, bool steal, Job& job) {
+            WorkerQueue& queue = *queues[index];
+            lock_guard<mutex> lock(queue.queueMutex);
+            deque<Job>& jobs = queue.jobs[priority];
+            if (jobs.empty()) {
+                return false;
+            }
+            if (steal) {
+                job = move(jobs.front());
+                jobs.pop_front();
+            }
+            else {
+                job = move(jobs.back());
+                jobs.pop_back();
+            }
+            queue.depth--;
+            queued.fetch_sub(1, memory_order_relaxed);
+            return true;
+        }
+
+        bool takeJob(size_t index, Job& job) {
+            for (int priority = 0; priority < TASK_PRIORITY_COUNT; ++priority) {
+                if (takeFrom(index, priority, false, job)) {
+                    return true;
+                }
+                for (size_t offset = 1; offset < queues.size(); ++offset) {
+                    if (takeFrom((index + offset) % queues.size(), priority, true, job)) {
+                        stolen.fetch_add(1, memory_order_relaxed);
+                        return true;
+                    }
+                }
+            }
+            return false;
+        }
+
+        void execute(Job& job) {
+            auto started = chrono::steady_clock::now();
+            job.run();
+            auto finished = chrono::steady_clock::now();
+
+            Timing& timing = timings[static_cast<int>(job.priority)];
+            uint64_t waited = static_cast<uint64_t>(chrono::duration_cast<chrono::nanoseconds>(started - job.queuedAt).count());
+            timing.executed.fetch_add(1, memory_order_relaxed);
+            timing.waitNanos.fetch_add(waited, memory_order_relaxed);
+            timing.runNanos.fetch_add(static_cast<uint64_t>(chrono::duration_cast<chrono::nanoseconds>(finished - started).count()),
+                memory_order_relaxed);
+            uint64_t longest = timing.maxWaitNanos.load(memory_order_relaxed);
+            while (waited > longest && !timing.maxWaitNanos.compare_exchange_weak(longest, waited, memory_order_relaxed)) {
+            }
+        }
+
+        void workerLoop(size_t index) {
+            currentWorker() = make_pair(this, index);
+            Job job;
+            for (;;) {
+                if (takeJob(index, job)) {
+                    execute(job);
+                    job.run = nullptr; // Drop captures now rather than at the next task
+                    continue;
+                }
+                unique_lock<mutex> lock(sleepMutex);
+                wakeUp.wait(lock, [this]() { return stopping || queued.load() > 0; });
+                if (stopping && queued.load() == 0) {
+                    return;
+                }
+            }
+        }
+
+    public:
+        // Zero workers means one per hardware thread (at least two)
+        explicit WorkStealingPool(size_t workerCount = 0)
+            : stopping(false), queued(0), peakQueued(0), nextQueue(0), stolen(0) {
+            if (workerCount == 0) {
+                workerCount = max<size_t>(2, thread::hardware_concurrency());
+            }
+            for (size_t i = 0; i < workerCount; ++i) {
+                queues.emplace_back(new WorkerQueue());
+            }
+            for (size_t i = 0; i < workerCount; ++i) {
+                workers.emplace_back(&WorkStealingPool::workerLoop, this, i);
+            }
+        }
+
+        ~WorkStealingPool() {
+            {
+                lock_guard<mutex> lock(sleepMutex);
+                stopping = true;
+            }
+            wakeUp.notify_all();
+            for (auto& worker : workers) {
+                worker.join();
+            }
+        }
+
+        WorkStealingPool(const WorkStealingPool&) = delete;
+        WorkStealingPool& operator=(const WorkStealingPool&) = delete;
+
+        // Queue a job with no result
+        void post(function<void()> run, TaskPriority priority = TaskPriority::Normal) {
+            const auto& worker = currentWorker();
+            size_t index = worker.first == this ? worker.second
+                : nextQueue.fetch_add(1, memory_order_relaxed) % queues.size();
+            {
+                WorkerQueue& queue = *queues[index];
+                lock_guard<mutex> lock(queue.queueMutex);
+                queue.jobs[static_cast<int>(priority)].push_back(Job{ move(run), priority, chrono::steady_clock::now() });
+                queue.depth++;
+                // Counted before the lock lets a worker take the job, so the
+                // worker's decrement can't come first and wrap 'queued'
+                size_t waiting = queued.fetch_add(1, memory_order_relaxed) + 1;
+                size_t peak = peakQueued.load(memory_order_relaxed);
+                while (waiting > peak && !peakQueued.compare_exchange_weak(peak, waiting, memory_order_relaxed)) {
+                }
+            }
+            {
+                lock_guard<mutex> lock(sleepMutex); // Pairs with the workers' wait so no wake-up is lost
+            }
+            wakeUp.notify_one();
+        }
+
+        // Queue fn and get a future for its result
+        template<typename F>
+        TaskFuture<invoke_result_t<F>> submit(F fn, TaskPriority priority = TaskPriority::Normal);
+
+        // Called by a worker that is blocked on a future: run one queued task
+        // instead, so waiting inside the pool cannot starve it
+        bool runOneIfWorker() {
+            const auto& worker = currentWorker();
+            Job job;
+            if (worker.first != this || !takeJob(worker.second, job)) {
+                return false;
+            }
+            execute(job);
+            return true;
+        }
+
+        size_t workerCount() const { return workers.size(); }
+
+        Stats stats() const {
+            Stats result;
+            result.workers = workers.size();
+            result.queued = queued.load();
+            result.peakQueued = peakQueued.load();
+            result.stolen = stolen.load();
+            for (const auto& queue : queues) {
+                lock_guard<mutex> lock(queue->queueMutex);
+                result.depthByWorker.push_back(queue->depth);
+            }
+            for (int priority = 0; priority < TASK_PRIORITY_COUNT; ++priority) {
+                const Timing& timing = timings[priority];
+                uint64_t executed = timing.executed.load();
+                PriorityStats& out = result.byPriority[priority];
+                out.executed = executed;
+                out.averageWaitMicros = executed > 0 ? timing.waitNanos.load() / 1000.0 / executed : 0.0;
+                out.maxWaitMicros = timing.maxWaitNanos.load() / 1000.0;
+                out.averageRunMicros = executed > 0 ? timing.runNanos.load() / 1000.0 / executed : 0.0;
+            }
+            return result;
+        }
+    };
+
+    template<typename R, typename F>
+    struct ContinuationResult {
+        typedef invoke_result_t<F, const R&> type;
+    };
+
+    template<typename F>
+    struct ContinuationResult<void, F> {
+        typedef invoke_result_t<F> type;
+    };
+
+    // Handle to a task's eventual result. Copies share the same result.
+    template<typename R>
+    class TaskFuture {
+    private:
+        shared_ptr<TaskState<R>> state;
+        WorkStealingPool* pool;
+
+    public:
+        TaskFuture() : pool(nullptr) {}
+        TaskFuture(shared_ptr<TaskState<R>> state, WorkStealingPool* pool) : state(move(state)), pool(pool) {}
+
+        bool valid() const { return state != nullptr; }
+        bool isReady() const { return state->isDone(); }
+
+        // Block until done; a worker keeps running other tasks meanwhile
+        void wait() const {
+            while (!state->isDone()) {
+                if (!pool->runOneIfWorker()) {
+                    state->waitFor(chrono::milliseconds(1));
+                }
+            }
+        }
+
+        // The result, or the task's exception rethrown
+        typename TaskState<R>::Stored get() const {
+            wait();
+            if (state->getError()) {
+                rethrow_exception(state->getError());
+            }
+            return state->getValue();
+        }
+
+        // Queue fn(result) once this task finishes (fn() for void tasks). If
+        // this task threw, fn is skipped and the returned future rethrows.
+        template<typename F>
+        TaskFuture<typename ContinuationResult<R, F>::type> then(F fn, TaskPriority priority = TaskPriority::Normal) const {
+            typedef typename ContinuationResult<R, F>::type Next;
+            auto next = make_shared<TaskState<Next>>();
+            shared_ptr<TaskState<R>> source = state;
+            WorkStealingPool* owner = pool;
+            source->onReady([owner, source, next, fn, priority]() {
+                owner->post([source, next, fn]() mutable {
+                    if (source->getError()) {
+                        next->fail(source->getError());
+                        return;
+                    }
+                    if constexpr (is_void<R>::value) {
+                        next->run(fn);
+                    }
+                    else {
+                        auto call = [&fn, &source]() { return fn(source->getValue()); };
+                        next->run(call);
+                    }
+                    }, priority);
+                });
+            return TaskFuture<Next>(next, owner);
+        }
+    };
+
+    template<typename F>
+    TaskFuture<invoke_result_t<F>> WorkStealingPool::submit(F fn, TaskPriority priority) {
+        typedef invoke_result_t<F> R;
+        auto state = make_shared<TaskState<R>>();
+        post([state, fn]() mutable { state->run(fn); }, priority);
+        return TaskFuture<R>(state, this);
+    }
+
+    // In-process publish/subscribe for one event type. publish() only copies
+    // the event into the pending batch; flush() hands everything pending to
+    // every subscriber as one contiguous batch, in publish order. The pending
+    // and dispatch buffers are swapped rather than reallocated, so once they
+    // have grown to the busiest batch neither side allocates. Subscribers run
+    // on the thread that calls flush(), one batch at a time, and publish()
+    // never runs them, so it is safe to publish while holding other locks.
+    template<typename Event>
+    class EventBus {
+    public:
+        typedef function<void(const Event* events, size_t count)> Subscriber;
+
+    private:
+        mutex pendingMutex;
+        vector<Event> pending;
+        mutex dispatchMutex; // Held for a whole flush so batches never interleave
+        vector<Event> dispatching;
+        vector<Subscriber> subscribers;
+        function<void()> requestFlush;
+        atomic<uint64_t> published;
+        atomic<uint64_t> delivered;
+        atomic<uint64_t> batches;
+
+    public:
+        // Room for reservedBatch events before either buffer first grows
+        explicit EventBus(size_t reservedBatch = 256) : published(0), delivered(0), batches(0) {
+            pending.reserve(reservedBatch);
+            dispatching.reserve(reservedBatch);
+        }
+
+        EventBus(const EventBus&) = delete;
+        EventBus& operator=(const EventBus&) = delete;
+
+        void subscribe(Subscriber subscriber) {
+            lock_guard<mutex> lock(dispatchMutex);
+            subscribers.push_back(move(subscriber));
+        }
+
+        // Called (outside the bus's locks) whenever an event lands in an empty
+        // batch, e.g. to queue a flush on a worker thread. Set it before
+        // anything is published.
+        void onFlushNeeded(function<void()> request) {
+            lock_guard<mutex> lock(pendingMutex);
+            requestFlush = move(request);
+        }
+
+        void publish(const Event& event) {
+            bool first;
+            {
+                lock_guard<mutex> lock(pendingMutex);
+                first = pending.empty();
+                pending.push_back(event);
+            }
+            published.fetch_add(1, memory_order_relaxed);
+            if (first && requestFlush) {
+                requestFlush();
+            }
+        }
+
+        // Deliver everything published so far; returns how many events that was
+        size_t flush() {
+            lock_guard<mutex> dispatchLock(dispatchMutex);
+            {
+                lock_guard<mutex> lock(pendingMutex);
+                pending.swap(dispatching);
+            }
+            size_t count = dispatching.size();
+            if (count == 0) {
+                return 0;
+            }
+            for (const auto& subscriber : subscribers) {
+                subscriber(dispatching.data(), count);
+            }
+            dispatching.clear(); // Keeps its capacity for the next swap
+            delivered.fetch_add(count, memory_order_relaxed);
+            batches.fetch_add(1, memory_order_relaxed);
+            return count;
+        }
+
+        uint64_t getPublished() const { return published.load(); }
+        uint64_t getDelivered() const { return delivered.load(); }
+        uint64_t getBatches() const { return batches.load(); }
+    };
+
+    // Fixed-size records in a named shared-memory segment: one producer
+    // process writes, any number of reader processes follow along. Each slot
+    // carries a sequence stamp (odd while being written) so readers detect
+    // torn or overwritten slots without locks; a reader that falls more than
+    // Capacity behind skips ahead and counts what it lost. The segment
+    // outlives the producer: a restarted producer picks up the sequence where
+    // the last one stopped and bumps the epoch, so readers carry on. Only one
+    // producer may have the segment open at a time; a second one fails to open.
+    template<typename Record, size_t Capacity>
+    class SharedRing {
+    private:
+        static_assert(is_trivially_copyable<Record>::value, "shared records are copied byte for byte");
+        static_assert(atomic<uint64_t>::is_always_lock_free, "atomics in shared memory must be lock-free");
+
+        static const uint32_t MAGIC = 0x4B524E47; // "KRNG"
+        static const uint32_t LAYOUT_VERSION = 1;
+
+        struct Header {
+            atomic<uint32_t> magic; // Written last by the producer that lays the segment out
+            uint32_t layoutVersion;
+            uint32_t recordSize;
+            uint32_t capacity;
+            atomic<uint64_t> epoch;     // Bumped by every producer start
+            atomic<uint64_t> published; // Records written so far, so also the next sequence
+        };
+
+        struct Slot {
+            atomic<uint64_t> stamp; // 2 * sequence + 1 while writing, + 2 once written
+            Record record;
+        };
+
+        struct Layout {
+            Header header;
+            alignas(64) Slot slots[Capacity];
+        };
+
+        Layout* layout;
+        bool producer;
+        uint64_t cursor;    // Reader: next sequence to read
+        uint64_t seenEpoch; // Reader: producer epoch at the last poll
+        uint64_t lost;
+        uint64_t restarts;
+#ifdef _WIN32
+        HANDLE mapping;
+        HANDLE producerLock; // Named mutex held for as long as this producer is open
+#else
+        int fd; // A producer holds an exclusive flock on it
+#endif
+
+        bool mapSegment(const string& name) {
+#ifdef _WIN32
+            string mappingName = "Local\\" + name;
+            if (producer) {
+                producerLock = CreateMutexA(nullptr, FALSE, (mappingName + ".producer").c_str());
+                if (producerLock == nullptr) {
+                    return false;
+                }
+                if (GetLastError() == ERROR_ALREADY_EXISTS) {
+                    CloseHandle(producerLock);
+                    producerLock = nullptr;
+                    return false;
+                }
+            }
+            mapping = producer
+                ? CreateFileMappingA(INVALID_HANDLE_VALUE, nullptr, PAGE_READWRITE, 0, static_cast<DWORD>(sizeof(Layout)), mappingName.c_str())
+                : OpenFileMappingA(FILE_MAP_READ, FALSE, mappingName.c_str());
+            if (mapping == nullptr) {
+                return false;
+            }
+            void* view = MapViewOfFile(mapping, producer ? FILE_MAP_ALL_ACCESS : FILE_MAP_READ, 0, 0, sizeof(Layout));
+            if (view == nullptr) {
+                CloseHandle(mapping);
+                mapping = nullptr;
+                return false;
+            }
+            layout = static_cast<Layout*>(view);
+            return true;
+#else
+            string path = "/" + name;
+            fd = producer ? shm_open(path.c_str(), O_CREAT | O_RDWR, 0600) : shm_open(path.c_str(), O_RDONLY, 0);
+            if (fd < 0) {
+                return false;
+            }
+            if (producer && flock(fd, LOCK_EX | LOCK_NB) != 0) {
+                ::close(fd); // Another producer has it
+                fd = -1;
+                return false;
+            }
+            struct stat info;
+            if (fstat(fd, &info) != 0 || (producer && static_cast<size_t>(info.st_size) != sizeof(Layout) && ftruncate(fd, sizeof(Layout)) != 0)
+                || (!producer && static_cast<size_t>(info.st_size) < sizeof(Layout))) {
+                ::close(fd);
+                fd = -1;
+                return false;
+            }
+            void* view = mmap(nullptr, sizeof(Layout), producer ? PROT_READ | PROT_WRITE : PROT_READ, MAP_SHARED, fd, 0);
+            if (view == MAP_FAILED) {
+                ::close(fd);
+                fd = -1;
+                return false;
+            }
+            layout = static_cast<Layout*>(view);
+            return true;
+#endif
+        }
+
+        bool layoutMatches() const {
+            const Header& header = layout->header;
+            return header.magic.load(memory_order_acquire) == MAGIC && header.layoutVersion == LAYOUT_VERSION
+                && header.recordSize == sizeof(Record) && header.capacity == Capacity;
+        }
+
+        // Producer: keep the sequence of a compatible segment, otherwise start afresh
+        void claim() {
+            Header& header = layout->header;
+            if (!layoutMatches()) {
+                header.magic.store(0, memory_order_relaxed);
+                for (size_t i = 0; i < Capacity; ++i) {
+                    layout->slots[i].stamp.store(0, memory_order_relaxed);
+                }
+                header.layoutVersion = LAYOUT_VERSION;
+                header.recordSize = sizeof(Record);
+                header.capacity = Capacity;
+                header.published.store(0, memory_order_relaxed);
+                header.magic.store(MAGIC, memory_order_release);
+            }
+            header.epoch.fetch_add(1, memory_order_acq_rel);
+        }
+
+        // Reader: follow a restarted producer; a fresh segment starts over
+        void checkEpoch(uint64_t head) {
+            uint64_t epoch = layout->header.epoch.load(memory_order_acquire);
+            if (epoch != seenEpoch) {
+                if (seenEpoch != 0) {
+                    restarts++;
+                }
+                seenEpoch = epoch;
+                if (head < cursor) {
+                    cursor = 0;
+                }
+            }
+        }
+
+    public:
+        // Producers create the segment if needed; readers need it to exist
+        SharedRing(const string& name, bool producer)
+            : layout(nullptr), producer(producer), cursor(0), seenEpoch(0), lost(0), restarts(0) {
+#ifdef _WIN32
+            mapping = nullptr;
+            producerLock = nullptr;
+#else
+            fd = -1;
+#endif
+            if (!mapSegment(name)) {
+                close(); // Also lets go of the producer lock if mapping failed after taking it
+                return;
+            }
+            if (producer) {
+                claim();
+            }
+            else if (!layoutMatches()) {
+                close();
+                return;
+            }
+            else {
+                // Start with whatever is still in the ring
+                uint64_t head = layout->header.published.load(memory_order_acquire);
+                cursor = head > Capacity ? head - Capacity : 0;
+                seenEpoch = layout->header.epoch.load(memory_order_acquire);
+            }
+        }
+
+        ~SharedRing() {
+            close();
+        }
+
+        SharedRing(const SharedRing&) = delete;
+        SharedRing& operator=(const SharedRing&) = delete;
+
+        bool isOpen() const { return layout != nullptr; }
+
+        void close() {
+#ifdef _WIN32
+            if (layout != nullptr) {
+                UnmapViewOfFile(layout);
+            }
+            if (mapping != nullptr) {
+                CloseHandle(mapping);
+                mapping = nullptr;
+            }
+            if (producerLock != nullptr) {
+                CloseHandle(producerLock);
+                producerLock = nullptr;
+            }
+#else
+            if (layout != nullptr) {
+                munmap(layout, sizeof(Layout));
+            }
+            if (fd >= 0) {
+                ::close(fd);
+                fd = -1;
+            }
+#endif
+            layout = nullptr;
+        }
+
+        // Producer only; returns the record's sequence number
+        uint64_t publish(const Record& record) {
+            Header& header = layout->header;
+            uint64_t sequence = header.published.load(memory_order_relaxed);
+            Slot& slot = layout->slots[sequence % Capacity];
+            slot.stamp.store(2 * sequence + 1, memory_order_relaxed);
+            atomic_thread_fence(memory_order_release);
+            memcpy(static_cast<void*>(&slot.record), &record, sizeof(Record));
+            slot.stamp.store(2 * sequence + 2, memory_order_release);
+            header.published.store(sequence + 1, memory_order_release);
+            return sequence;
+        }
+
+        // Reader only: append up to maxRecords new records to out (with their
+        // sequence numbers if asked) and return how many were added
+        size_t poll(vector<Record>& out, size_t maxRecords, vector<uint64_t>* sequences = nullptr) {
+            const Header& header = layout->header;
+            uint64_t head = header.published.load(memory_order_acquire);
+            checkEpoch(head);
+            size_t added = 0;
+            while (cursor < head && added < maxRecords) {
+                if (head - cursor > Capacity) {
+                    lost += head - Capacity - cursor; // Overwritten before we got to them
+                    cursor = head - Capacity;
+                }
+                const Slot& slot = layout->slots[cursor % Capacity];
+                uint64_t expected = 2 * cursor + 2;
+                uint64_t before = slot.stamp.load(memory_order_acquire);
+                Record copy;
+                if (before == expected) {
+                    memcpy(static_cast<void*>(&copy), &slot.record, sizeof(Record));
+                    atomic_thread_fence(memory_order_acquire);
+                    if (slot.stamp.load(memory_order_relaxed) == expected) {
+                        out.push_back(copy);
+                        if (sequences != nullptr) {
+                            sequences->push_back(cursor);
+                        }
+                        cursor++;
+                        added++;
+                        continue;
+                    }
+                }
+                else if (before < expected) {
+                    break; // Producer died mid-write; a restarted one rewrites this sequence
+                }
+                // Lapped while reading: move to the oldest slot that is still safe
+                head = header.published.load(memory_order_acquire);
+                uint64_t oldestSafe = head + 1 > Capacity ? head + 1 - Capacity : 0;
+                uint64_t next = max(cursor + 1, oldestSafe);
+                lost += next - cursor;
+                cursor = next;
+            }
+            return added;
+        }
+
+        // Reader only: true once the producer has written past our cursor
+        bool hasNew() const {
+            return layout->header.published.load(memory_order_acquire) > cursor;
+        }
+
+        uint64_t getPublished() const { return layout->header.published.load(memory_order_acquire); }
+        uint64_t getLost() const { return lost; }
+        uint64_t getRestarts() const { return restarts; }
+    };
+
+    // Pushes newline-delimited JSON updates to any number of local clients
+    // over a Unix-domain socket, from one epoll thread. Each update gets a
+    // sequence number and is kept in a bounded history. A client opens with
+    // "RESUME <n> [<instance>]" and gets a {"hello":...} line naming this
+    // server instance, then every kept update numbered n or later (a
+    // {"gap":...} line says if some were already dropped), then each new one
+    // live. A client that names a different instance has followed an earlier
+    // run of the server, whose numbers mean nothing here: it gets a
+    // {"reset":...} line and the whole history. Output waits in a per-client buffer while the socket is
+    // full; a client that lets it grow past the limit is disconnected and
+    // can reconnect and resume where it left off. Linux only; elsewhere
+    // start() fails.
+    class LineBroadcastServer {
+    public:
+        static const size_t HISTORY = 4096;
+        static const size_t CLIENT_BUFFER_LIMIT = 1 << 20;
+
+    private:
+        struct Client {
+            int fd;
+            string input;
+            string output;
+            size_t outputOffset; // Bytes of output already written
+            bool subscribed;
+            bool waitingToWrite; // EPOLLOUT armed
+        };
+
+        string socketPath;
+        uint64_t instance; // Distinguishes this run from earlier ones on the same socket
+        RingBuffer<pair<uint64_t, string>> history;
+        mutex queueMutex;
+        vector<pair<uint64_t, string>> queued; // Published but not yet handed to the loop
+        uint64_t nextSequence;
+        atomic<bool> stopping;
+        atomic<size_t> clientCount;
+        atomic<uint64_t> disconnectedSlow;
+        thread loop;
+#ifdef __linux__
+        int listenFd;
+        int epollFd;
+        int wakeFd;
+        unordered_map<int, Client> clients;
+        uint64_t loopSequence = 0; // One past the newest update in history
+        bool boundPath = false;    // The socket file is ours to remove on stop()
+
+        void watch(int fd, uint32_t events, bool modify) {
+            epoll_event event = {};
+            event.events = events;
+            event.data.fd = fd;
+            epoll_ctl(epollFd, modify ? EPOLL_CTL_MOD : EPOLL_CTL_ADD, fd, &event);
+        }
+
+        void dropClient(int fd) {
+            epoll_ctl(epollFd, EPOLL_CTL_DEL, fd, nullptr);
+            ::close(fd);
+            clients.erase(fd);
+            clientCount.store(clients.size());
+        }
+
+        // Write as much as the socket takes; false if the client had to go
+        bool flushClient(Client& client) {
+            while (client.outputOffset < client.output.size()) {
+                ssize_t written = ::send(client.fd, client.output.data() + client.outputOffset,
+                    client.output.size() - client.outputOffset, MSG_NOSIGNAL);
+                if (written > 0) {
+                    client.outputOffset += static_cast<size_t>(written);
+                    continue;
+                }
+                if (written < 0 && (errno == EAGAIN || errno == EWOULDBLOCK)) {
+                    break;
+                }
+                if (written < 0 && errno == EINTR) {
+                    continue;
+                }
+                return false;
+            }
+            if (client.outputOffset == client.output.size()) {
+                client.output.clear();
+                client.outputOffset = 0;
+            }
+            else if (client.outputOffset > client.output.size() / 2) {
+                client.output.erase(0, client.outputOffset); // Keep the buffer from creeping forward
+                client.outputOffset = 0;
+            }
+            if (client.output.size() - client.outputOffset > CLIENT_BUFFER_LIMIT) {
+                disconnectedSlow++;
+                return false;
+            }
+            bool pending = !client.output.empty();
+            if (pending != client.waitingToWrite) {
+                client.waitingToWrite = pending;
+                watch(client.fd, EPOLLIN | EPOLLRDHUP | (pending ? static_cast<uint32_t>(EPOLLOUT) : 0u), true);
+            }
+            return true;
+        }
+
+        void handleCommand(Client& client, const string& line) {
+            if (line.compare(0, 7, "RESUME ") != 0 || client.subscribed) {
+                return;
+            }
+            char* rest = nullptr;
+            uint64_t from = strtoull(line.c_str() + 7, &rest, 10);
+            uint64_t clientInstance = strtoull(rest, nullptr, 10);
+            uint64_t oldest = history.empty() ? loopSequence : history.at(0).first;
+            client.output += "{\"hello\":{\"instance\":" + to_string(instance) + ",\"oldest\":" + to_string(oldest)
+                + ",\"next\":" + to_string(loopSequence) + "}}\n";
+            if ((clientInstance != 0 && clientInstance != instance) || from > loopSequence) {
+                // Numbering restarted with the server: start the client over
+                client.output += "{\"reset\":{\"next\":" + to_string(oldest) + "}}\n";
+                from = oldest;
+            }
+            else if (from < oldest) {
+                client.output += "{\"gap\":{\"from\":" + to_string(from) + ",\"to\":" + to_string(oldest) + "}}\n";
+            }
+            for (size_t i = 0; i < history.size(); ++i) {
+                if (history.at(i).first >= from) {
+                    client.output += history.at(i).second;
+                }
+            }
+            client.subscribed = true;
+        }
+
+        void readClient(int fd) {
+            Client& client = clients[fd];
+            char buffer[512];
+            for (;;) {
+                ssize_t received = ::recv(fd, buffer, sizeof(buffer), 0);
+                if (received > 0) {
+                    client.input.append(buffer, static_cast<size_t>(received));
+                    continue;
+                }
+                if (received < 0 && (errno == EAGAIN || errno == EWOULDBLOCK)) {
+                    break;
+                }
+                if (received < 0 && errno == EINTR) {
+                    continue;
+                }
+                dropClient(fd); // Closed or failed
+                return;
+            }
+            size_t newline;
+            while ((newline = client.input.find('\n')) != string::npos) {
+                string line = client.input.substr(0, newline);
+                client.input.erase(0, newline + 1);
+                if (!line.empty() && line.back() == '\r') {
+                    line.pop_back();
+                }
+                handleCommand(client, line);
+            }
+            if (client.input.size() > 4096) {
+                dropClient(fd); // Not speaking the protocol
+                return;
+            }
+            if (!flushClient(client)) {
+                dropClient(fd);
+            }
+        }
+
+        void acceptClients() {
+            for (;;) {
+                int fd = accept4(listenFd, nullptr, nullptr, SOCK_NONBLOCK | SOCK_CLOEXEC);
+                if (fd < 0) {
+                    return;
+                }
+                clients[fd] = Client{ fd, string(), string(), 0, false, false };
+                clientCount.store(clients.size());
+                watch(fd, EPOLLIN | EPOLLRDHUP, false);
+            }
+        }
+
+        // Move newly published lines into the history and every subscriber's buffer
+        void distribute() {
+            uint64_t counter;
+            while (::read(wakeFd, &counter, sizeof(counter)) > 0) {
+            }
+            vector<pair<uint64_t, string>> batch;
+            {
+                lock_guard<mutex> lock(queueMutex);
+                batch.swap(queued);
+            }
+            if (batch.empty()) {
+                return;
+            }
+            for (auto& entry : batch) {
+                for (auto& client : clients) {
+                    if (client.second.subscribed) {
+                        client.second.output += entry.second;
+                    }
+                }
+                loopSequence = entry.first + 1;
+                history.push(move(entry));
+            }
+            vector<int> failed;
+            for (auto& client : clients) {
+                if (client.second.subscribed && !flushClient(client.second)) {
+                    failed.push_back(client.first);
+                }
+            }
+            for (int fd : failed) {
+                dropClient(fd);
+            }
+        }
+
+        void runLoop() {
+            epoll_event events[64];
+            while (!stopping.load()) {
+                int ready = epoll_wait(epollFd, events, 64, 500);
+                for (int i = 0; i < ready; ++i) {
+                    int fd = events[i].data.fd;
+                    if (fd == listenFd) {
+                        acceptClients();
+                    }
+                    else if (fd == wakeFd) {
+                        distribute();
+                    }
+                    else if (clients.count(fd) != 0) {
+                        if (events[i].events & (EPOLLIN | EPOLLRDHUP | EPOLLHUP | EPOLLERR)) {
+                            readClient(fd);
+                        }
+                        else if ((events[i].events & EPOLLOUT) && !flushClient(clients[fd])) {
+                            dropClient(fd);
+                        }
+                    }
+                }
+            }
+            for (auto& client : clients) {
+                ::close(client.first);
+            }
+            clients.clear();
+            clientCount.store(0);
+        }
+#endif
+
+    public:
+        explicit LineBroadcastServer(const string& socketPath)
+            : socketPath(socketPath),
+            instance(static_cast<uint64_t>(chrono::system_clock::now().time_since_epoch().count()) | 1),
+            history(HISTORY), nextSequence(0), stopping(false), clientCount(0), disconnectedSlow(0)
+#ifdef __linux__
+            , listenFd(-1), epollFd(-1), wakeFd(-1)
+#endif
+        {
+        }
+
+        ~LineBroadcastServer() {
+            stop();
+        }
+
+        LineBroadcastServer(const LineBroadcastServer&) = delete;
+        LineBroadcastServer& operator=(const LineBroadcastServer&) = delete;
+
+        // Bind the socket and start the loop thread. A socket file left by a
+        // server that is gone is replaced; fails if a live server answers on it
+        bool start() {
+#ifdef __linux__
+            sockaddr_un address = {};
+            address.sun_family = AF_UNIX;
+            if (socketPath.size() >= sizeof(address.sun_path)) {
+                return false;
+            }
+            strncpy(address.sun_path, socketPath.c_str(), sizeof(address.sun_path) - 1);
+            int probe = ::socket(AF_UNIX, SOCK_STREAM | SOCK_CLOEXEC, 0);
+            if (probe < 0) {
+                return false;
+            }
+            bool live = ::connect(probe, reinterpret_cast<sockaddr*>(&address), sizeof(address)) == 0;
+            bool stale = !live && errno == ECONNREFUSED; // Nobody listening behind the file
+            ::close(probe);
+            if (live) {
+                return false;
+            }
+            if (stale) {
+                ::unlink(socketPath.c_str());
+            }
+
+            listenFd = ::socket(AF_UNIX, SOCK_STREAM | SOCK_NONBLOCK | SOCK_CLOEXEC, 0);
+            epollFd = epoll_create1(EPOLL_CLOEXEC);
+            wakeFd = eventfd(0, EFD_NONBLOCK | EFD_CLOEXEC);
+            if (listenFd < 0 || epollFd < 0 || wakeFd < 0
+                || ::bind(listenFd, reinterpret_cast<sockaddr*>(&address), sizeof(address)) != 0
+                || ::listen(listenFd, 64) != 0) {
+                stop();
+                return false;
+            }
+            boundPath = true;
+            watch(listenFd, EPOLLIN, false);
+            watch(wakeFd, EPOLLIN, false);
+            loop = thread(&LineBroadcastServer::runLoop, this);
+            return true;
+#else
+            return false;
+#endif
+        }
+
+        void stop() {
+#ifdef __linux__
+            stopping = true;
+            if (loop.joinable()) {
+                uint64_t one = 1;
+                ssize_t ignored = ::write(wakeFd, &one, sizeof(one));
+                (void)ignored;
+                loop.join();
+            }
+            for (int* fd : { &listenFd, &epollFd, &wakeFd }) {
+                if (*fd >= 0) {
+                    ::close(*fd);
+                    *fd = -1;
+                }
+            }
+            if (boundPath) {
+                ::unlink(socketPath.c_str());
+                boundPath = false;
+            }
+#endif
+        }
+
+        // Queue {"seq":N,<fields>} for every client; fields is the inside of a
+        // JSON object. Safe from any thread; returns the sequence number.
+        uint64_t broadcast(const string& fields) {
+            uint64_t sequence;
+            {
+                lock_guard<mutex> lock(queueMutex);
+                sequence = nextSequence++;
+                queued.emplace_back(sequence, "{\"seq\":" + to_string(sequence) + "," + fields + "}\n");
+            }
+#ifdef __linux__
+            uint64_t one = 1;
+            ssize_t ignored = ::write(wakeFd, &one, sizeof(one));
+            (void)ignored;
+#endif
+            return sequence;
+        }
+
+        size_t getClientCount() const { return clientCount.load(); }
+        uint64_t getSlowDisconnects() const { return disconnectedSlow.load(); }
+        const string& getSocketPath() const { return socketPath; }
+    };
+
+    // Client side of LineBroadcastServer: connects, asks to resume from the
+    // first update it has not seen yet, and hands each line to the caller.
+    // Reconnecting after a drop picks up exactly where it stopped. Linux only.
+    class LineStreamClient {
+    private:
+        string socketPath;
+        int fd;
+        string input;
+        uint64_t nextSequence;
+        uint64_t serverInstance; // From the last hello; 0 before the first
+
+        static bool readNumberAfter(const string& line, const string& key, uint64_t& value) {
+            size_t at = line.find(key);
+            if (at == string::npos) {
+                return false;
+            }
+            value = strtoull(line.c_str() + at + key.size(), nullptr, 10);
+            return true;
+        }
 
-    // Base class for records (renamed for clarity)
-    class stbase {
     public:
-        virtual ~stbase() = default; // Default destructor for proper cleanup
-        virtual string toString() const = 0; // Pure virtual function for string conversion
+        explicit LineStreamClient(const string& socketPath) : socketPath(socketPath), fd(-1), nextSequence(0), serverInstance(0) {}
 
-        // Get current timestamp
-        static string getCurrentTimeMark() {
-            auto nowTime = chrono::system_clock::now();
-            time_t currentTime = chrono::system_clock::to_time_t(nowTime);
+        ~LineStreamClient() {
+            disconnect();
+        }
 
-            char buffer[26]; // Need 26 chars for proper date/time format
+        LineStreamClient(const LineStreamClient&) = delete;
+        LineStreamClient& operator=(const LineStreamClient&) = delete;
 
-#ifdef _WIN32
-            ctime_s(buffer, sizeof(buffer), &currentTime);
+        bool connect() {
+#ifdef __linux__
+            disconnect();
+            sockaddr_un address = {};
+            address.sun_family = AF_UNIX;
+            if (socketPath.size() >= sizeof(address.sun_path)) {
+                return false;
+            }
+            strncpy(address.sun_path, socketPath.c_str(), sizeof(address.sun_path) - 1);
+            fd = ::socket(AF_UNIX, SOCK_STREAM | SOCK_CLOEXEC, 0);
+            if (fd < 0 || ::connect(fd, reinterpret_cast<sockaddr*>(&address), sizeof(address)) != 0) {
+                disconnect();
+                return false;
+            }
+            string hello = "RESUME " + to_string(nextSequence) + " " + to_string(serverInstance) + "\n";
+            if (::send(fd, hello.data(), hello.size(), MSG_NOSIGNAL) != static_cast<ssize_t>(hello.size())) {
+                disconnect();
+                return false;
+            }
+            return true;
 #else
-            ctime_r(&currentTime, buffer);
+            return false;
 #endif
+        }
 
-            string timestamp(buffer);
-            if (!timestamp.empty() && timestamp[timestamp.length() - 1] == '\n') {
-                timestamp.pop_back(); // Remove newline character
+        void disconnect() {
+#ifdef __linux__
+            if (fd >= 0) {
+                ::close(fd);
             }
-            return timestamp;
+#endif
+            fd = -1;
+            input.clear();
+        }
+
+        bool isConnected() const { return fd >= 0; }
+        uint64_t getNextSequence() const { return nextSequence; }
+
+        // Wait up to timeoutMs and pass every complete line to onLine.
+        // Returns false once the server has gone away.
+        template<typename Func>
+        bool receive(Func onLine, int timeoutMs) {
+#ifdef __linux__
+            if (fd < 0) {
+                return false;
+            }
+            pollfd waitFor = { fd, POLLIN, 0 };
+            int ready = ::poll(&waitFor, 1, timeoutMs);
+            if (ready <= 0) {
+                return ready == 0 || errno == EINTR;
+            }
+            char buffer[4096];
+            ssize_t received = ::recv(fd, buffer, sizeof(buffer), 0);
+            if (received <= 0) {
+                disconnect();
+                return false;
+            }
+            input.append(buffer, static_cast<size_t>(received));
+            size_t start = 0, newline;
+            while ((newline = input.find('\n', start)) != string::npos) {
+                string line = input.substr(start, newline - start);
+                start = newline + 1;
+                uint64_t value;
+                if (readNumberAfter(line, "{\"seq\":", value)) {
+                    nextSequence = value + 1;
+                }
+                else if (readNumberAfter(line, "{\"hello\":{\"instance\":", value)) {
+                    serverInstance = value;
+                    continue; // Protocol only
+                }
+                else if (readNumberAfter(line, "{\"reset\":{\"next\":", value)) {
+                    nextSequence = value;
+                }
+                onLine(line);
+            }
+            input.erase(0, start);
+            return true;
+#else
+            (void)onLine;
+            (void)timeoutMs;
+            return false;
+#endif
         }
     };
 
-    // LiveMonitor class - standalone monitoring functionality
-    class LiveMonitor {
-    private:
-        static void clearScreen() {
+    inline void clearConsole() {
 #ifdef _WIN32
-            system("cls");
+        system("cls");
 #else
-            system("clear");
+        system("clear");
 #endif
+    }
+
+    // What changed between two monitor snapshots. Row indexes refer to the
+    // newer snapshot unless noted; the vectors keep their capacity from one
+    // refresh to the next.
+    struct MonitorDiff {
+        bool full = true;       // Redraw everything: first frame, or the differ can't say what changed
+        vector<size_t> changed; // Rows in both snapshots whose contents differ
+        vector<size_t> added;   // Rows the previous snapshot did not have
+        size_t removed = 0;     // Rows the previous snapshot had that this one does not
+        vector<size_t> removedRows; // Those rows by index in the previous snapshot, if the differ knows them
+        size_t previousSize = 0;
+
+        void reset(size_t previousRows) {
+            full = false;
+            changed.clear();
+            added.clear();
+            removed = 0;
+            removedRows.clear();
+            previousSize = previousRows;
+        }
+
+        bool any() const {
+            return full || !changed.empty() || !added.empty() || removed != 0;
+        }
+    };
+
+    // Differ that only notices a change in the number of rows, redrawing everything when it does
+    struct CountDiffer {
+        template<typename T>
+        void operator()(const vector<T>& previous, const vector<T>& current, MonitorDiff& diff) const {
+            diff.full = previous.size() != current.size();
+        }
+    };
+
+    // Differ that compares rows position by position
+    template<typename Equal = equal_to<>>
+    struct RowDiffer {
+        Equal equal;
+
+        template<typename T>
+        void operator()(const vector<T>& previous, const vector<T>& current, MonitorDiff& diff) const {
+            size_t common = previous.size() < current.size() ? previous.size() : current.size();
+            for (size_t i = 0; i < common; ++i) {
+                if (!equal(previous[i], current[i])) {
+                    diff.changed.push_back(i);
+                }
+            }
+            for (size_t i = common; i < current.size(); ++i) {
+                diff.added.push_back(i);
+            }
+            diff.removed = previous.size() - common;
+        }
+    };
+
+    // Differ that matches rows by key, so a row leaving or moving marks no
+    // other row as changed. KeyOf maps a row to something with ==. Each key
+    // is looked for just past the previous match first, which finds it at
+    // once while the rows keep their order.
+    template<typename KeyOf, typename Equal = equal_to<>>
+    struct KeyedDiffer {
+        KeyOf keyOf;
+        Equal equal;
+        mutable vector<char> matched; // Per previous row; keeps its capacity
+
+        KeyedDiffer(KeyOf keyOf = KeyOf(), Equal equal = Equal()) : keyOf(move(keyOf)), equal(move(equal)) {}
+
+        template<typename T>
+        void operator()(const vector<T>& previous, const vector<T>& current, MonitorDiff& diff) const {
+            matched.assign(previous.size(), 0);
+            size_t start = 0;
+            for (size_t i = 0; i < current.size(); ++i) {
+                size_t found = previous.size();
+                for (size_t step = 0; step < previous.size(); ++step) {
+                    size_t j = (start + step) % previous.size();
+                    if (!matched[j] && keyOf(previous[j]) == keyOf(current[i])) {
+                        found = j;
+                        break;
+                    }
+                }
+                if (found == previous.size()) {
+                    diff.added.push_back(i);
+                    continue;
+                }
+                matched[found] = 1;
+                start = found + 1;
+                if (!equal(previous[found], current[i])) {
+                    diff.changed.push_back(i);
+                }
+            }
+            for (size_t j = 0; j < previous.size(); ++j) {
+                if (!matched[j]) {
+                    diff.removedRows.push_back(j);
+                }
+            }
+            diff.removed = diff.removedRows.size();
+        }
+    };
+
+    template<typename KeyOf>
+    KeyedDiffer<KeyOf> diffByKey(KeyOf keyOf) {
+        return KeyedDiffer<KeyOf>(move(keyOf));
+    }
+
+    // Renderer that prints each row's toString(): every row on a full frame,
+    // otherwise only the rows that changed; then the rows that went away
+    struct RowRenderer {
+        template<typename T>
+        void operator()(const vector<T>& rows, const MonitorDiff& diff, const vector<T>& previous) const {
+            if (diff.full) {
+                for (const auto& row : rows) {
+                    cout << row.toString() << '\n';
+                }
+            }
+            else {
+                for (size_t index : diff.changed) {
+                    cout << "~ " << rows[index].toString() << '\n';
+                }
+                for (size_t index : diff.added) {
+                    cout << "+ " << rows[index].toString() << '\n';
+                }
+            }
+            for (size_t index : diff.removedRows) {
+                cout << "- " << previous[index].toString() << '\n';
+            }
+            if (diff.removedRows.empty() && diff.removed != 0) {
+                cout << "- " << diff.removed << " row(s) removed\n";
+            }
         }
+    };
+
+    // Live monitor whose data source, change detection and drawing are
+    // compile-time policies:
+    //   bool Provider(vector<T>& out)  - refill out in place; false if nothing new (out untouched)
+    //   void Differ(previous, current, MonitorDiff&)
+    //   void Renderer(const vector<T>& rows, const MonitorDiff&, const vector<T>& previous)
+    // Two snapshots are kept and swapped after each comparison, so a refresh
+    // copies nothing and, once their capacity has settled, allocates nothing.
+    // The previous snapshot stays valid until the next fetch().
+    template<typename T, typename Provider, typename Renderer = RowRenderer, typename Differ = RowDiffer<>>
+    class PolicyMonitor {
+    private:
+        Provider provider;
+        Renderer renderer;
+        Differ differ;
+        static const int PARTIAL_FRAMES_PER_REDRAW = 10;
+        vector<T> shown;    // Snapshot last compared; what is on screen
+        vector<T> incoming; // Filled by the provider, then swapped with shown
+        MonitorDiff diff;
+        bool fetched;       // incoming holds a snapshot not compared yet
+        bool drawnOnce;
 
     public:
-        // Generic monitor function that works with any data source and display function
-        template<typename DataType>
-        static void startMonitor(
-            function<vector<DataType>()> dataProvider,              // Function to get data
-            function<void(const vector<DataType>&)> displayFunc,    // Function to display data
-            function<bool(const vector<DataType>&, const vector<DataType>&)> hasChangesFunc, // Change detection
-            int refreshInterval = 3
-        ) {
-            clearScreen();
+        PolicyMonitor(Provider provider, Renderer renderer = Renderer(), Differ differ = Differ())
+            : provider(move(provider)), renderer(move(renderer)), differ(move(differ)), fetched(false), drawnOnce(false) {}
+
+        // Ask the provider for a new snapshot. May run off the monitor's
+        // thread, but never together with update()
+        void fetch() {
+            if (provider(incoming)) {
+                fetched = true;
+            }
+        }
+
+        // Compare the fetched snapshot with the shown one and make it current.
+        // Returns true if there is anything to draw
+        bool update() {
+            if (!fetched && drawnOnce) {
+                return false;
+            }
+            diff.reset(shown.size());
+            if (!drawnOnce) {
+                diff.full = true;
+                if (!fetched) {
+                    incoming.clear();
+                }
+            }
+            else {
+                differ(shown, incoming, diff);
+            }
+            fetched = false;
+            drawnOnce = true;
+            swap(shown, incoming);
+            return diff.any();
+        }
+
+        // Draw the result of the last update()
+        void render() {
+            renderer(static_cast<const vector<T>&>(shown), static_cast<const MonitorDiff&>(diff), static_cast<const vector<T>&>(incoming));
+        }
+
+        const vector<T>& current() const { return shown; }
+        const MonitorDiff& lastDiff() const { return diff; }
+
+        // Refresh until Enter is pressed, fetching on pool if one is given
+        void run(int refreshInterval = 3, WorkStealingPool* pool = nullptr) {
+            clearConsole();
             cout << "Starting live monitoring. Screen will refresh every "
                 << refreshInterval << " seconds when changes detected." << endl;
             cout << "Press Enter to return to menu." << endl;
 
-            vector<DataType> lastData;
-            string lastDisplayTimestamp;
-            bool needsRefresh = true;  // Force initial display
             bool running = true;
 
             // Ensure input buffer is clear
             cin.ignore(numeric_limits<streamsize>::max(), '\n');
 
+            TaskFuture<void> nextFetch;
+            int partialFrames = 0;
             while (running) {
-                // Get current data
-                vector<DataType> currentData = dataProvider();
-                string currentTimestamp = stbase::getCurrentTimeMark();
-
-                // Check for changes
-                bool hasChanges = needsRefresh || hasChangesFunc(currentData, lastData);
-
-                if (hasChanges) {
-                    clearScreen();
-                    cout << "===== LIVE MONITOR =====" << endl;
-                    cout << "Refreshing every " << refreshInterval << " seconds when changes detected" << endl;
-                    cout << "Last updated: " << currentTimestamp << endl;
-                    cout << "(Press Enter to return to menu)" << endl << endl;
+                if (nextFetch.valid()) {
+                    nextFetch.get();
+                    nextFetch = TaskFuture<void>();
+                }
+                else {
+                    fetch();
+                }
 
-                    // Display notifications about changes if needed
-                    if (lastData.size() < currentData.size() && !lastData.empty()) {
-                        cout << "*** NEW DATA RECEIVED! ***" << endl << endl;
+                if (update()) {
+                    // Partial frames stack up below the board and a removal
+                    // shifts the rows under it, so redraw the whole board then
+                    if (diff.removed != 0 || partialFrames >= PARTIAL_FRAMES_PER_REDRAW) {
+                        diff.full = true;
                     }
+                    partialFrames = diff.full ? 0 : partialFrames + 1;
+                    string currentTimestamp = stbase::getCurrentTimeMark();
+                    if (diff.full) {
+                        clearConsole();
+                        cout << "===== LIVE MONITOR =====" << endl;
+                        cout << "Refreshing every " << refreshInterval << " seconds when changes detected" << endl;
+                        cout << "Last updated: " << currentTimestamp << endl;
+                        cout << "(Press Enter to return to menu)" << endl << endl;
 
-                    // Call display function
-                    displayFunc(currentData);
-
-                    // Update last known state
-                    lastData = currentData;
-                    lastDisplayTimestamp = currentTimestamp;
-                    needsRefresh = false;
+                        if (diff.previousSize != 0 && diff.previousSize < shown.size()) {
+                            cout << "*** NEW DATA RECEIVED! ***" << endl << endl;
+                        }
+                    }
+                    else {
+                        cout << endl << "--- Updated " << currentTimestamp << " ---" << endl;
+                    }
+                    render();
+                    cout.flush();
                 }
 
                 // More efficient polling with longer sleep intervals
                 auto startTime = chrono::steady_clock::now();
                 while (chrono::duration_cast<chrono::seconds>(
                     chrono::steady_clock::now() - startTime).count() < refreshInterval) {
+                    // Start the next read shortly before it is needed
+                    if (pool != nullptr && !nextFetch.valid() &&
+                        chrono::steady_clock::now() - startTime >= chrono::seconds(refreshInterval) - chrono::milliseconds(500)) {
+                        nextFetch = pool->submit([this]() { fetch(); }, TaskPriority::Normal);
+                    }
                     if (_kbhit()) {
                         char ch = _getch();
                         if (ch == '\r' || ch == '\n') {
@@ -123,9 +1942,47 @@ namespace TwoCli {
                 }
             }
 
+            if (nextFetch.valid()) {
+                nextFetch.wait(); // The fetch writes into this monitor
+            }
             cout << "Exiting monitor mode..." << endl;
             this_thread::sleep_for(chrono::milliseconds(500));
         }
+    };
+
+    // Deduces the policy types; only the row type has to be named
+    template<typename T, typename Provider, typename Renderer = RowRenderer, typename Differ = RowDiffer<>>
+    PolicyMonitor<T, Provider, Renderer, Differ> makeMonitor(Provider provider, Renderer renderer = Renderer(), Differ differ = Differ()) {
+        return PolicyMonitor<T, Provider, Renderer, Differ>(move(provider), move(renderer), move(differ));
+    }
+
+    // LiveMonitor class - standalone monitoring functionality
+    class LiveMonitor {
+    public:
+        // Generic monitor function that works with any data source and display function.
+        // Convenience over PolicyMonitor for callers holding std::functions; every
+        // detected change redraws the whole screen
+        template<typename DataType>
+        static void startMonitor(
+            function<vector<DataType>()> dataProvider,              // Function to get data
+            function<void(const vector<DataType>&)> displayFunc,    // Function to display data
+            function<bool(const vector<DataType>&, const vector<DataType>&)> hasChangesFunc, // Change detection
+            int refreshInterval = 3,
+            WorkStealingPool* pool = nullptr // If given, the next refresh is fetched there while this thread waits
+        ) {
+            auto monitor = makeMonitor<DataType>(
+                [dataProvider](vector<DataType>& out) {
+                    out = dataProvider();
+                    return true;
+                },
+                [displayFunc](const vector<DataType>& rows, const MonitorDiff&, const vector<DataType>&) {
+                    displayFunc(rows);
+                },
+                [hasChangesFunc](const vector<DataType>& previous, const vector<DataType>& current, MonitorDiff& diff) {
+                    diff.full = hasChangesFunc(current, previous);
+                });
+            monitor.run(refreshInterval, pool);
+        }
 
         // Simple count-based change detector
         template<typename T>
@@ -134,6 +1991,243 @@ namespace TwoCli {
         }
     };
 
+    // Renderer for monitors whose snapshots are drawn by someone else (see DashboardPanel)
+    struct NullRenderer {
+        template<typename T>
+        void operator()(const vector<T>&, const MonitorDiff&, const vector<T>&) const {}
+    };
+
+    // When a dashboard panel refreshes: every 'interval' (zero: not on a
+    // timer), and after notify() for it, but no sooner than 'minimumGap'
+    // after its last refresh, so a burst of notifications costs one refresh.
+    struct PanelRefresh {
+        chrono::milliseconds interval;
+        chrono::milliseconds minimumGap;
+
+        static PanelRefresh every(chrono::milliseconds interval) {
+            return PanelRefresh{ interval, chrono::milliseconds(0) };
+        }
+
+        static PanelRefresh onNotify(chrono::milliseconds minimumGap, chrono::milliseconds interval = chrono::milliseconds(0)) {
+            return PanelRefresh{ interval, minimumGap };
+        }
+    };
+
+    // One panel of a Dashboard, whatever its row type
+    class DashboardPanelBase {
+    public:
+        virtual ~DashboardPanelBase() {}
+        virtual bool refresh() = 0; // Fetch and compare; true if the panel changed
+        virtual void render(ostream& out, bool markChanges) const = 0;
+        virtual size_t rowCount() const = 0;
+    };
+
+    // A panel over rows of type T. Provider and Differ are PolicyMonitor
+    // policies; Formatter is void(ostream&, const T&) and writes one line.
+    // Rows that changed in the last refresh are marked with '*'.
+    template<typename T, typename Provider, typename Formatter, typename Differ = RowDiffer<>>
+    class DashboardPanel : public DashboardPanelBase {
+    private:
+        PolicyMonitor<T, Provider, NullRenderer, Differ> monitor;
+        Formatter format;
+
+    public:
+        DashboardPanel(Provider provider, Formatter format, Differ differ)
+            : monitor(move(provider), NullRenderer(), move(differ)), format(move(format)) {}
+
+        bool refresh() override {
+            monitor.fetch();
+            return monitor.update();
+        }
+
+        void render(ostream& out, bool markChanges) const override {
+            const vector<T>& rows = monitor.current();
+            const MonitorDiff& diff = monitor.lastDiff();
+            if (rows.empty()) {
+                out << "  (none)\n";
+                return;
+            }
+            // Both index lists are ascending, so one pass finds every marked row
+            size_t nextChanged = 0;
+            size_t nextAdded = 0;
+            for (size_t i = 0; i < rows.size(); ++i) {
+                bool marked = false;
+                if (markChanges && !diff.full) {
+                    while (nextChanged < diff.changed.size() && diff.changed[nextChanged] < i) {
+                        ++nextChanged;
+                    }
+                    while (nextAdded < diff.added.size() && diff.added[nextAdded] < i) {
+                        ++nextAdded;
+                    }
+                    marked = (nextChanged < diff.changed.size() && diff.changed[nextChanged] == i)
+                        || (nextAdded < diff.added.size() && diff.added[nextAdded] == i);
+                }
+                out << (marked ? "* " : "  ");
+                format(out, rows[i]);
+                out << '\n';
+            }
+        }
+
+        size_t rowCount() const override { return monitor.current().size(); }
+    };
+
+    // Several panels, each with its own source and refresh policy, kept up to
+    // date by one loop thread. The loop sleeps until the earliest panel is due
+    // or notify() is called, refreshes only the panels that are due, and draws
+    // the whole frame once if any of them changed. Sources are whatever the
+    // providers read: files, state published in process, or sockets polled
+    // without blocking. Providers run on the loop thread only.
+    class Dashboard {
+    private:
+        struct Slot {
+            string title;
+            PanelRefresh refresh;
+            unique_ptr<DashboardPanelBase> panel;
+            chrono::steady_clock::time_point lastRefresh;
+            atomic<bool> notified;
+            bool changed;
+
+            Slot(const string& title, PanelRefresh refresh, DashboardPanelBase* panel)
+                : title(title), refresh(refresh), panel(panel), notified(false), changed(false) {}
+        };
+
+        string title;
+        vector<unique_ptr<Slot>> slots; // Fixed once the loop starts
+        ostringstream frame;            // Built in full, then written in one go
+        mutex wakeMutex;
+        condition_variable wake;
+        bool wakeRequested;
+        bool stopping;
+        thread loop;
+        atomic<uint64_t> frames;
+        atomic<uint64_t> refreshes;
+
+        void drawFrame() {
+            frame.str("");
+            frame.clear();
+            frame << "===== " << title << " =====\n";
+            frame << "Updated " << stbase::getCurrentTimeMark() << " | frame " << (frames.load() + 1)
+                << " | Press Enter to return to menu\n\n";
+            for (const auto& slot : slots) {
+                bool updated = slot->changed && frames.load() > 0;
+                frame << "--- " << slot->title << " (" << slot->panel->rowCount() << ")"
+                    << (updated ? " [updated]" : "") << " ---\n";
+                slot->panel->render(frame, updated);
+                frame << '\n';
+            }
+            clearConsole();
+            cout << frame.str() << flush;
+            frames.fetch_add(1);
+        }
+
+        void run() {
+            unique_lock<mutex> lock(wakeMutex);
+            for (bool firstPass = true; firstPass || !stopping; firstPass = false) {
+                lock.unlock();
+                auto now = chrono::steady_clock::now();
+                auto nextDue = now + chrono::hours(1);
+                bool anyChanged = firstPass;
+                for (auto& slot : slots) {
+                    const PanelRefresh& policy = slot->refresh;
+                    auto sinceLast = now - slot->lastRefresh;
+                    bool timerDue = policy.interval.count() > 0 && sinceLast >= policy.interval;
+                    bool notifyDue = slot->notified.load() && sinceLast >= policy.minimumGap;
+                    slot->changed = false;
+                    if (firstPass || timerDue || notifyDue) {
+                        slot->notified.store(false); // Before the refresh, so a notify during it is kept
+                        slot->changed = slot->panel->refresh();
+                        slot->lastRefresh = now;
+                        refreshes.fetch_add(1);
+                        anyChanged = anyChanged || slot->changed;
+                    }
+                    if (policy.interval.count() > 0 && slot->lastRefresh + policy.interval < nextDue) {
+                        nextDue = slot->lastRefresh + policy.interval;
+                    }
+                    if (slot->notified.load() && slot->lastRefresh + policy.minimumGap < nextDue) {
+                        nextDue = slot->lastRefresh + policy.minimumGap;
+                    }
+                }
+                if (anyChanged) {
+                    drawFrame();
+                }
+
+                lock.lock();
+                wake.wait_until(lock, nextDue, [this]() { return stopping || wakeRequested; });
+                wakeRequested = false;
+            }
+        }
+
+    public:
+        explicit Dashboard(const string& title)
+            : title(title), wakeRequested(false), stopping(false), frames(0), refreshes(0) {}
+
+        Dashboard(const Dashboard&) = delete;
+        Dashboard& operator=(const Dashboard&) = delete;
+
+        ~Dashboard() {
+            stop();
+        }
+
+        // Add a panel before start(); returns its index for notify()
+        template<typename T, typename Provider, typename Formatter, typename Differ = RowDiffer<>>
+        size_t addPanel(const string& panelTitle, PanelRefresh refresh, Provider provider, Formatter format, Differ differ = Differ()) {
+            slots.emplace_back(new Slot(panelTitle, refresh,
+                new DashboardPanel<T, Provider, Formatter, Differ>(move(provider), move(format), move(differ))));
+            return slots.size() - 1;
+        }
+
+        // Tell the loop a panel's source has changed. Safe from any thread
+        void notify(size_t panel) {
+            if (panel >= slots.size()) {
+                return;
+            }
+            slots[panel]->notified.store(true);
+            {
+                lock_guard<mutex> lock(wakeMutex);
+                wakeRequested = true;
+            }
+            wake.notify_one();
+        }
+
+        void start() {
+            if (!loop.joinable()) {
+                stopping = false;
+                loop = thread(&Dashboard::run, this);
+            }
+        }
+
+        void stop() {
+            {
+                lock_guard<mutex> lock(wakeMutex);
+                stopping = true;
+            }
+            wake.notify_one();
+            if (loop.joinable()) {
+                loop.join();
+            }
+        }
+
+        // Run the loop until Enter is pressed on this thread. The caller has
+        // already consumed the line that opened the dashboard.
+        void runUntilEnter() {
+            start();
+            while (true) {
+                if (_kbhit()) {
+                    char ch = _getch();
+                    if (ch == '\r' || ch == '\n') {
+                        break;
+                    }
+                }
+                this_thread::sleep_for(chrono::milliseconds(100));
+            }
+            stop();
+            cout << "Exiting dashboard..." << endl;
+        }
+
+        uint64_t getFrames() const { return frames.load(); }
+        uint64_t getRefreshes() const { return refreshes.load(); }
+    };
+
     // Forward declaration
     template<typename R>
     class FileManager;
@@ -146,6 +2240,15 @@ namespace TwoCli {
         mutex file_mutex;
 
     public:
+        // When and how big the file was last written, by any process
+        struct Stamp {
+            filesystem::file_time_type modified{};
+            uintmax_t size = 0;
+
+            bool operator==(const Stamp& other) const { return modified == other.modified && size == other.size; }
+            bool operator!=(const Stamp& other) const { return !(*this == other); }
+        };
+
         FileManager(const string& file) : filename(file) {
             // Create empty file if it doesn't exist
             ifstream checkFile(filename);
@@ -155,10 +2258,26 @@ namespace TwoCli {
             }
         }
 
+        // Take this before reading, so a write during the read shows up next time
+        Stamp stamp() const {
+            Stamp result;
+            error_code error;
+            result.modified = filesystem::last_write_time(filename, error);
+            result.size = error ? 0 : filesystem::file_size(filename, error);
+            return result;
+        }
+
         // Read all records from file
         vector<R> readRecords() {
-            lock_guard<mutex> lock(file_mutex);
             vector<R> records;
+            readRecordsInto(records);
+            return records;
+        }
+
+        // Read all records into out, reusing its elements and capacity
+        void readRecordsInto(vector<R>& out) {
+            lock_guard<mutex> lock(file_mutex);
+            size_t count = 0;
 
             ifstream file(filename);
             if (file.is_open()) {
@@ -166,7 +2285,14 @@ namespace TwoCli {
                 while (getline(file, line)) {
                     if (!line.empty()) {
                         try {
-                            records.push_back(R::fromString(line));
+                            R record = R::fromString(line);
+                            if (count < out.size()) {
+                                out[count] = move(record);
+                            }
+                            else {
+                                out.push_back(move(record));
+                            }
+                            ++count;
                         }
                         catch (...) {
                             cerr << "Warning: Skipped invalid line in file" << endl;
@@ -176,7 +2302,7 @@ namespace TwoCli {
                 file.close();
             }
 
-            return records;
+            out.erase(out.begin() + static_cast<ptrdiff_t>(count), out.end());
         }
 
         // Write records to file
@@ -204,6 +2330,92 @@ namespace TwoCli {
             return writeRecords(records);
         }
 
+        // Append a single record without rewriting the file.
+        // Returns the byte offset the record was written at, or -1 on failure.
+        long long appendRecord(const R& record) {
+            lock_guard<mutex> lock(file_mutex);
+
+            ofstream file(filename, ios::binary | ios::app);
+            if (!file.is_open()) {
+                cerr << "Error: Could not open file for appending: " << filename << endl;
+                return -1;
+            }
+            file.seekp(0, ios::end);
+            long long offset = static_cast<long long>(file.tellp());
+            file << record.toString() << '\n';
+            file.flush();
+            return file.good() ? offset : -1;
+        }
+
+        // Append several records with one open of the file
+        bool appendRecords(const vector<R>& records) {
+            lock_guard<mutex> lock(file_mutex);
+
+            ofstream file(filename, ios::binary | ios::app);
+            if (!file.is_open()) {
+                cerr << "Error: Could not open file for appending: " << filename << endl;
+                return false;
+            }
+            for (const auto& record : records) {
+                file << record.toString() << '\n';
+            }
+            file.flush();
+            return file.good();
+        }
+
+        // Read the record that starts at a byte offset returned by appendRecord/forEachRecord
+        bool readRecordAt(long long offset, R& out) {
+            lock_guard<mutex> lock(file_mutex);
+
+            ifstream file(filename, ios::binary);
+            if (!file.is_open()) {
+                return false;
+            }
+            file.seekg(offset);
+            string line;
+            if (!getline(file, line) || line.empty()) {
+                return false;
+            }
+            try {
+                out = R::fromString(line);
+                return true;
+            }
+            catch (...) {
+                return false;
+            }
+        }
+
+        // Stream every record through fn(record, offset) without loading the whole file
+        template<typename Func>
+        void forEachRecord(Func fn) {
+            lock_guard<mutex> lock(file_mutex);
+
+            ifstream file(filename, ios::binary);
+            if (!file.is_open()) {
+                return;
+            }
+            string line;
+            long long offset = static_cast<long long>(file.tellg());
+            while (getline(file, line)) {
+                long long next = static_cast<long long>(file.tellg());
+                if (!line.empty()) {
+                    bool parsed = true;
+                    R record;
+                    try {
+                        record = R::fromString(line);
+                    }
+                    catch (...) {
+                        cerr << "Warning: Skipped invalid line in file" << endl;
+                        parsed = false;
+                    }
+                    if (parsed) {
+                        fn(record, offset);
+                    }
+                }
+                offset = next;
+            }
+        }
+
         // Get next available ID for new records
         int getNextId() {
             auto records = readRecords();
@@ -227,20 +2439,17 @@ namespace TwoCli {
             }
         }
 
-        // Watch the file with live updates
-        void watch(int refreshInterval = 3) {
-            // Create a data provider lambda that returns records from this file
-            auto dataProvider = [this]() {
-                return this->readRecords();
-                };
-
-            // Start monitoring with default display and change detection functions
-            LiveMonitor::startMonitor<R>(
-                dataProvider,
-                basicDisplayFunction,
-                LiveMonitor::countChangeDetector<R>,
-                refreshInterval
-            );
+        // Watch the file with live updates, reading it on pool if one is given
+        void watch(int refreshInterval = 3, WorkStealingPool* pool = nullptr) {
+            // Refill one snapshot from this file on each refresh, redrawing when the count changes
+            auto monitor = makeMonitor<R>(
+                [this](vector<R>& out) {
+                    this->readRecordsInto(out);
+                    return true;
+                },
+                RowRenderer(),
+                CountDiffer());
+            monitor.run(refreshInterval, pool);
         }
     };
 